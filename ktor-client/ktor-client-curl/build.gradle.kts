@@ -30,8 +30,11 @@ kotlin {
         }
         desktopTest.dependencies {
             implementation(projects.ktorClientTests)
+            implementation(projects.ktorClientCio)
             implementation(projects.ktorClientLogging)
             implementation(projects.ktorClientJson)
+            implementation(projects.ktorServerCio)
+            implementation(projects.ktorServerPartialContent)
             implementation(libs.kotlinx.serialization.json)
         }
     }
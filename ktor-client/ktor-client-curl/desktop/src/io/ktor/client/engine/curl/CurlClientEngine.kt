@@ -21,9 +21,17 @@ internal class CurlClientEngine(
     override val config: CurlClientEngineConfig
 ) : HttpClientEngineBase("ktor-curl") {
 
-    override val supportedCapabilities = setOf(HttpTimeoutCapability, WebSocketCapability, SSECapability)
-
-    private val curlProcessor = CurlProcessor(coroutineContext)
+    override val supportedCapabilities =
+        setOf(
+            HttpTimeoutCapability,
+            WebSocketCapability,
+            WebSocketExtensionsCapability,
+            SSECapability,
+            UnixSocketCapability,
+            CurlRequestCapability,
+        )
+
+    private val curlProcessor = CurlProcessor(coroutineContext, config)
 
     @OptIn(InternalAPI::class)
     override suspend fun execute(data: HttpRequestData): HttpResponseData {
@@ -40,9 +48,17 @@ internal class CurlClientEngine(
                 readLineStrict()
             }
             val rawHeaders = parseHeaders(headerBytes)
+            val decodeOffThread = curlRequest.offloadContentDecoding &&
+                !curlRequest.passThroughContentEncoding &&
+                data.hasDecodableBody(rawHeaders)
+            // Without libcurl decoding, a body in an unsupported encoding is passed as is
+            val keepCompressionHeaders = curlRequest.passThroughContentEncoding ||
+                curlRequest.offloadContentDecoding && !decodeOffThread
             val headers = rawHeaders
                 .toBuilder().apply {
-                    dropCompressionHeaders(data.method, data.attributes)
+                    if (!keepCompressionHeaders) dropCompressionHeaders(data.method, data.attributes)
+                    // The body goes to a file, so the body channel is empty
+                    if (curlRequest.downloadPath != null) remove(HttpHeaders.ContentLength)
                 }.build()
 
             rawHeaders.release()
@@ -50,24 +66,31 @@ internal class CurlClientEngine(
             val status = HttpStatusCode.fromValue(status)
 
             val responseBody: Any = if (data.isUpgradeRequest() && status == HttpStatusCode.SwitchingProtocols) {
-                val wsConfig = data.attributes[WEBSOCKETS_KEY]
                 val websocket = responseBody as CurlWebSocketResponseBody
                 CurlWebSocketSession(
                     websocket,
                     callContext,
-                    wsConfig.channelsConfig.outgoing,
                     curlProcessor,
-                )
+                ).also { data.attributes.put(WebSocketSessionKey, it) }
             } else if (data.isUpgradeRequest()) {
                 // Server rejected the upgrade (e.g., 401 Unauthorized). The easy handle is already
                 // cleaned up by this point — don't create a WebSocket session or cancelWebSocket
                 // would enqueue a stale handle that may be reallocated for the retry request.
                 ByteReadChannel.Empty
+            } else if (responseBody is CurlFileResponseBody) {
+                data.attributes.put(DownloadedFileKey, responseBody.downloadedFile)
+                responseBody.bodyChannel
             } else {
                 val httpResponse = responseBody as CurlHttpResponseBody
+                data.attributes.put(ResponseTrailersKey, httpResponse.trailers)
+                val bodyChannel = if (decodeOffThread) {
+                    decodeContentOffThread(httpResponse.bodyChannel, callContext)
+                } else {
+                    httpResponse.bodyChannel
+                }
                 data.attributes.getOrNull(ResponseAdapterAttributeKey)
-                    ?.adapt(data, status, headers, httpResponse.bodyChannel, data.body, callContext)
-                    ?: httpResponse.bodyChannel
+                    ?.adapt(data, status, headers, bodyChannel, data.body, callContext)
+                    ?: bodyChannel
             }
 
             HttpResponseData(
@@ -85,6 +108,12 @@ internal class CurlClientEngine(
         super.close()
         curlProcessor.close()
     }
+
+    private fun HttpRequestData.hasDecodableBody(headers: HttpHeadersMap): Boolean {
+        if (method == HttpMethod.Head || method == HttpMethod.Options) return false
+        val contentEncoding = headers[HttpHeaders.ContentEncoding]?.toString()?.lowercase() ?: return false
+        return contentEncoding in OFFLOADED_CONTENT_ENCODINGS
+    }
 }
 
 @Deprecated("This exception will be removed in a future release in favor of a better error handling.")
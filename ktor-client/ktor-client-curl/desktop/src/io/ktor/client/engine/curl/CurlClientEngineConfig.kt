@@ -41,4 +41,170 @@ public class CurlClientEngineConfig : HttpClientEngineConfig() {
      * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlClientEngineConfig.sslVerify)
      */
     public var sslVerify: Boolean = true
+
+    /**
+     * Sends all requests over a Unix domain socket at the given path using `CURLOPT_UNIX_SOCKET_PATH`
+     * instead of opening a TCP connection to the host from the request URL.
+     * The URL host is still used for the `Host` header and TLS.
+     *
+     * A socket set for a single request with `unixSocket(path)` takes precedence over this value.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlClientEngineConfig.unixSocketPath)
+     */
+    public var unixSocketPath: String? = null
+
+    /**
+     * Treats Unix domain socket paths as names in the Linux abstract socket namespace
+     * by passing them as `CURLOPT_ABSTRACT_UNIX_SOCKET` instead of `CURLOPT_UNIX_SOCKET_PATH`.
+     * Applies to both [unixSocketPath] and paths set with `unixSocket(path)`.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlClientEngineConfig.abstractUnixSocket)
+     */
+    public var abstractUnixSocket: Boolean = false
+
+    /**
+     * Limits the upload rate of each request in bytes per second using `CURLOPT_MAX_SEND_SPEED_LARGE`.
+     * Can be overridden for a single request with `curl { maxSendSpeed = ... }`.
+     * `null` means no limit.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlClientEngineConfig.maxSendSpeed)
+     */
+    public var maxSendSpeed: Long? = null
+        set(value) {
+            require(value == null || value > 0) { "maxSendSpeed should be positive, but was $value" }
+            field = value
+        }
+
+    /**
+     * Limits the download rate of each request in bytes per second using `CURLOPT_MAX_RECV_SPEED_LARGE`.
+     * Can be overridden for a single request with `curl { maxReceiveSpeed = ... }`.
+     * `null` means no limit.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlClientEngineConfig.maxReceiveSpeed)
+     */
+    public var maxReceiveSpeed: Long? = null
+        set(value) {
+            require(value == null || value > 0) { "maxReceiveSpeed should be positive, but was $value" }
+            field = value
+        }
+
+    /**
+     * Limits the aggregate upload rate of all HTTP transfers of the engine in bytes per second.
+     * The budget is split evenly between the active transfers and is rebalanced
+     * each time a transfer starts or finishes. WebSocket sessions are not limited.
+     * `null` means no limit.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlClientEngineConfig.maxTotalSendSpeed)
+     */
+    public var maxTotalSendSpeed: Long? = null
+        set(value) {
+            require(value == null || value > 0) { "maxTotalSendSpeed should be positive, but was $value" }
+            field = value
+        }
+
+    /**
+     * Limits the aggregate download rate of all HTTP transfers of the engine in bytes per second.
+     * The budget is split evenly between the active transfers and is rebalanced
+     * each time a transfer starts or finishes. WebSocket sessions are not limited.
+     * `null` means no limit.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlClientEngineConfig.maxTotalReceiveSpeed)
+     */
+    public var maxTotalReceiveSpeed: Long? = null
+        set(value) {
+            require(value == null || value > 0) { "maxTotalReceiveSpeed should be positive, but was $value" }
+            field = value
+        }
+
+    /**
+     * Decodes `gzip` and `deflate` response bodies on [kotlinx.coroutines.Dispatchers.Default]
+     * instead of inside libcurl. All transfers of the engine share a single curl thread,
+     * so this keeps large compressed downloads from delaying other requests.
+     *
+     * When enabled, `CURLOPT_HTTP_CONTENT_DECODING` is turned off and only `gzip` and `deflate`
+     * are advertised in the `Accept-Encoding` header.
+     * Can be overridden for a single request with `curl { offloadContentDecoding = ... }`.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlClientEngineConfig.offloadContentDecoding)
+     */
+    public var offloadContentDecoding: Boolean = false
+
+    /**
+     * The number of times a `GET` response body interrupted by a connection failure is continued
+     * with a range request from the last received byte. The continuation is appended to the same body channel,
+     * so the caller only observes a slower response. `0` disables resuming.
+     *
+     * A body is resumed only if the response has a strong `ETag` or a `Last-Modified` header,
+     * which is sent as `If-Range` to make sure the resource hasn't changed.
+     * Resumable requests don't ask for compressed responses, since a decoded body can't be continued at a byte offset.
+     * Can be overridden for a single request with `curl { maxResumeAttempts = ... }`.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlClientEngineConfig.maxResumeAttempts)
+     */
+    public var maxResumeAttempts: Int = 0
+        set(value) {
+            require(value >= 0) { "maxResumeAttempts should not be negative, but was $value" }
+            field = value
+        }
+
+    /**
+     * Specifies if duplex streaming is enabled, so a server can stream the response body
+     * while the client is still sending the request body, as in bidirectional gRPC calls.
+     * The response is returned as soon as its headers arrive, and the request and response bodies
+     * are paused independently when their writer or reader falls behind.
+     *
+     * Duplex requests are sent over HTTP/2, which an HTTP/1.1 server doesn't accept for `http`,
+     * so only requests opting in with `curl { duplexStreaming = true }` are sent this way.
+     * Other requests with a streamed body are sent as usual.
+     *
+     * ```kotlin
+     * val client = HttpClient(Curl) {
+     *     engine { duplexStreamingEnabled = true }
+     * }
+     * client.preparePost("https://example.com/chat") {
+     *     setBody(requestChannel)
+     *     curl { duplexStreaming = true }
+     * }.execute { response -> ... }
+     * ```
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlClientEngineConfig.duplexStreamingEnabled)
+     */
+    public var duplexStreamingEnabled: Boolean = false
+
+    /**
+     * The interval in milliseconds after which a Ping frame is sent to a WebSocket server
+     * that hasn't sent anything since the previous check. `null` disables the heartbeat.
+     *
+     * Unlike `pingInterval` of the `WebSockets` plugin, the pings are scheduled by the curl thread itself,
+     * so idle sessions don't need a coroutine and a timer each. Any frame from the server counts as a response.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlClientEngineConfig.webSocketPingIntervalMillis)
+     */
+    public var webSocketPingIntervalMillis: Long? = null
+        set(value) {
+            require(value == null || value > 0) { "webSocketPingIntervalMillis should be positive, but was $value" }
+            field = value
+        }
+
+    /**
+     * The time in milliseconds a WebSocket server has to respond to a heartbeat Ping frame,
+     * see [webSocketPingIntervalMillis]. Otherwise, the session is closed
+     * with [io.ktor.client.network.sockets.SocketTimeoutException].
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlClientEngineConfig.webSocketPingTimeoutMillis)
+     */
+    public var webSocketPingTimeoutMillis: Long = 15_000
+        set(value) {
+            require(value > 0) { "webSocketPingTimeoutMillis should be positive, but was $value" }
+            field = value
+        }
+
+    /**
+     * Specifies if libcurl answers Ping frames from a WebSocket server with Pong frames by itself.
+     * When disabled (`CURLWS_NOAUTOPONG`), the Ping frames are only delivered to the session,
+     * so an application can reply with a custom payload.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlClientEngineConfig.webSocketAutoPong)
+     */
+    public var webSocketAutoPong: Boolean = true
 }
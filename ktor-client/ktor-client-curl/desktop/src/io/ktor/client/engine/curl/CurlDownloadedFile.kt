@@ -0,0 +1,51 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl
+
+import io.ktor.client.plugins.*
+import io.ktor.client.statement.*
+import io.ktor.http.*
+import io.ktor.util.*
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.io.files.Path
+
+internal val DownloadedFileKey = AttributeKey<CompletableDeferred<CurlDownloadedFile>>("CurlDownloadedFile")
+
+/**
+ * A file written by the [Curl] engine for a request with [CurlRequestConfig.downloadPath].
+ *
+ * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlDownloadedFile)
+ *
+ * @property path the path of the written file
+ * @property size the number of bytes written to the file
+ */
+public class CurlDownloadedFile(
+    public val path: Path,
+    public val size: Long,
+) {
+    override fun toString(): String = "CurlDownloadedFile(path=$path, size=$size)"
+}
+
+/**
+ * Waits until the response body is written to [CurlRequestConfig.downloadPath] and returns the written file.
+ * The body of an unsuccessful response isn't written to the file, so it fails with that body instead.
+ *
+ * ```kotlin
+ * val file = client.prepareGet("https://example.com/backup.tar") {
+ *     curl { downloadPath = Path("/var/backups/backup.tar") }
+ * }.execute { response -> response.downloadedFile() }
+ * ```
+ *
+ * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.downloadedFile)
+ *
+ * @throws IllegalStateException if the request wasn't executed by the [Curl] engine with a download path.
+ * @throws ResponseException if the response status is unsuccessful, with the response body in its message.
+ */
+public suspend fun HttpResponse.downloadedFile(): CurlDownloadedFile {
+    val downloadedFile = call.request.attributes.getOrNull(DownloadedFileKey)
+    checkNotNull(downloadedFile) { "The response body of ${call.request.url} wasn't downloaded to a file" }
+    if (!status.isSuccess()) throw ResponseException(this, bodyAsText())
+    return downloadedFile.await()
+}
@@ -17,7 +17,7 @@ import kotlin.coroutines.CoroutineContext
 import kotlin.coroutines.cancellation.CancellationException
 
 @OptIn(ExperimentalForeignApi::class)
-internal class CurlProcessor(coroutineContext: CoroutineContext) {
+internal class CurlProcessor(coroutineContext: CoroutineContext, config: CurlClientEngineConfig) {
 
     @OptIn(DelicateCoroutinesApi::class, ExperimentalCoroutinesApi::class)
     private val curlDispatcher = newSingleThreadContext("curl-dispatcher")
@@ -30,7 +30,13 @@ internal class CurlProcessor(coroutineContext: CoroutineContext) {
 
     init {
         val init = curlScope.launch {
-            curlApi = CurlMultiApiHandler()
+            curlApi = CurlMultiApiHandler(
+                maxTotalSendSpeed = config.maxTotalSendSpeed,
+                maxTotalReceiveSpeed = config.maxTotalReceiveSpeed,
+                webSocketPingIntervalMillis = config.webSocketPingIntervalMillis,
+                webSocketPingTimeoutMillis = config.webSocketPingTimeoutMillis,
+                webSocketAutoPong = config.webSocketAutoPong,
+            )
         }
 
         runBlocking {
@@ -49,13 +55,6 @@ internal class CurlProcessor(coroutineContext: CoroutineContext) {
         return result.await()
     }
 
-    suspend fun sendWebSocketFrame(websocket: CurlWebSocketResponseBody, flags: Int, data: ByteArray) {
-        val result = Job()
-        taskQueue.send(SendWebSocketFrame(websocket, flags, data, result))
-        curlApi!!.wakeup()
-        result.join()
-    }
-
     /**
      * Cancels a WebSocket easy handle by enqueuing a cancellation task.
      * Called when a WebSocket session is closed to ensure the curl easy handle
@@ -92,9 +91,6 @@ internal class CurlProcessor(coroutineContext: CoroutineContext) {
             when (task) {
                 is SendRequest -> handleSendRequest(api, task)
 
-                is SendWebSocketFrame ->
-                    api.sendWebSocketFrame(task.websocket, task.flags, task.data, task.completionHandler)
-
                 is CancelWebSocket ->
                     api.cancelWebSocket(task.websocket, CancellationException("WebSocket session closed"))
             }
@@ -144,13 +140,6 @@ private sealed interface CurlTask {
         val completionHandler: CompletableDeferred<CurlSuccess>,
     ) : CurlTask
 
-    class SendWebSocketFrame(
-        val websocket: CurlWebSocketResponseBody,
-        val flags: Int,
-        val data: ByteArray,
-        val completionHandler: CompletableJob,
-    ) : CurlTask
-
     class CancelWebSocket(
         val websocket: CurlWebSocketResponseBody,
     ) : CurlTask
@@ -0,0 +1,184 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl
+
+import io.ktor.client.engine.*
+import io.ktor.client.request.*
+import io.ktor.http.*
+import io.ktor.utils.io.*
+import kotlinx.io.files.Path
+
+/**
+ * Per-request settings of the [Curl] engine.
+ * Values set here take precedence over the matching [CurlClientEngineConfig] properties.
+ *
+ * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlRequestConfig)
+ */
+@KtorDsl
+public class CurlRequestConfig {
+    /**
+     * Limits the upload rate of the request body in bytes per second using `CURLOPT_MAX_SEND_SPEED_LARGE`.
+     * `null` means no limit.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlRequestConfig.maxSendSpeed)
+     */
+    public var maxSendSpeed: Long? = null
+        set(value) {
+            require(value == null || value > 0) { "maxSendSpeed should be positive, but was $value" }
+            field = value
+        }
+
+    /**
+     * Limits the download rate of the response body in bytes per second using `CURLOPT_MAX_RECV_SPEED_LARGE`.
+     * `null` means no limit.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlRequestConfig.maxReceiveSpeed)
+     */
+    public var maxReceiveSpeed: Long? = null
+        set(value) {
+            require(value == null || value > 0) { "maxReceiveSpeed should be positive, but was $value" }
+            field = value
+        }
+
+    /**
+     * Decodes a compressed response body off the curl thread.
+     * `null` means the value of [CurlClientEngineConfig.offloadContentDecoding] is used.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlRequestConfig.offloadContentDecoding)
+     */
+    public var offloadContentDecoding: Boolean? = null
+
+    /**
+     * The number of times an interrupted response body is continued from the last received byte.
+     * `null` means the value of [CurlClientEngineConfig.maxResumeAttempts] is used.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlRequestConfig.maxResumeAttempts)
+     */
+    public var maxResumeAttempts: Int? = null
+        set(value) {
+            require(value == null || value >= 0) { "maxResumeAttempts should not be negative, but was $value" }
+            field = value
+        }
+
+    /**
+     * Receives the response body exactly as it was sent by the server, without decoding it.
+     * The `Content-Encoding` and `Content-Length` response headers are kept intact,
+     * and the engine doesn't add an `Accept-Encoding` header, so the one set on the request is sent as is.
+     *
+     * This is useful for proxies and caches that forward compressed responses without recompressing them.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlRequestConfig.passThroughContentEncoding)
+     */
+    public var passThroughContentEncoding: Boolean = false
+
+    /**
+     * Writes the response body straight to the file at this path on the curl thread instead of the body channel.
+     * An existing file is overwritten, but only by the body of a response with a successful status.
+     *
+     * The response body channel receives no data and is closed once the file is complete.
+     * Use [downloadedFile] to get the written file and its size.
+     * The body of an unsuccessful response is received in the body channel instead, and the file is left untouched.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlRequestConfig.downloadPath)
+     */
+    public var downloadPath: Path? = null
+
+    /**
+     * The position in the [downloadPath] file where the response body is written.
+     * With a positive offset the file must exist, and its content outside the written range is kept.
+     * Useful together with a `Range` request header to fetch parts of a file separately.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlRequestConfig.downloadOffset)
+     */
+    public var downloadOffset: Long = 0
+        set(value) {
+            require(value >= 0) { "downloadOffset should not be negative, but was $value" }
+            field = value
+        }
+
+    /**
+     * Provides trailer fields sent after the request body using `CURLOPT_TRAILERFUNCTION`.
+     * The provider is called by the coroutine writing the body once the whole body is written,
+     * so it can return values computed while the body was written, such as a checksum.
+     * A provider that throws aborts the request.
+     *
+     * Trailers can only follow a `WriteChannelContent` body without `contentLength`, which is sent chunked.
+     * libcurl sends trailers only over HTTP/1.1, so a request with trailers is made with HTTP/1.1
+     * even if the server supports HTTP/2, and can't use [duplexStreaming].
+     * Announce the trailer names to the server with the `Trailer` request header.
+     *
+     * ```kotlin
+     * var written = 0L
+     * client.put("https://example.com/upload") {
+     *     header(HttpHeaders.Trailer, "X-Content-Size")
+     *     setBody(
+     *         ChannelWriterContent(
+     *             body = {
+     *                 for (part in parts) {
+     *                     writeFully(part)
+     *                     written += part.size
+     *                 }
+     *             },
+     *             contentType = ContentType.Application.OctetStream
+     *         )
+     *     )
+     *     curl { requestTrailers = { headersOf("X-Content-Size", written.toString()) } }
+     * }
+     * ```
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlRequestConfig.requestTrailers)
+     */
+    public var requestTrailers: (() -> Headers)? = null
+
+    /**
+     * Sends the request with duplex streaming, see [CurlClientEngineConfig.duplexStreamingEnabled],
+     * which has to be enabled for the engine. Applies only to a streamed body, such as a `WriteChannelContent`.
+     *
+     * The request is sent over HTTP/2, negotiated with ALPN for `https` and with prior knowledge for `http`,
+     * so a plain `http` server must accept HTTP/2 without an upgrade.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlRequestConfig.duplexStreaming)
+     */
+    public var duplexStreaming: Boolean = false
+
+    /**
+     * Delivers the messages of a WebSocket session to [incomingMessages] as they arrive,
+     * each with a content channel fed chunk by chunk, instead of assembling whole frames for `incoming`.
+     * Receiving is paused while the content isn't read, so a message of any size is received in bounded memory,
+     * and `maxFrameSize` doesn't apply. Control frames are still handled by the session.
+     *
+     * Extensions process whole frames, so they are not negotiated for such a session.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlRequestConfig.streamWebSocketMessages)
+     */
+    public var streamWebSocketMessages: Boolean = false
+}
+
+/**
+ * A [Curl] engine capability carrying [CurlRequestConfig] of a request.
+ *
+ * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlRequestCapability)
+ */
+public data object CurlRequestCapability : HttpClientEngineCapability<CurlRequestConfig>
+
+/**
+ * Configures [Curl] engine specific settings of the request.
+ * Requests with these settings can only be executed by the [Curl] engine.
+ *
+ * ```kotlin
+ * client.get("https://example.com/backup.tar") {
+ *     curl {
+ *         maxReceiveSpeed = 1024 * 1024
+ *     }
+ * }
+ * ```
+ *
+ * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.curl)
+ */
+public fun HttpRequestBuilder.curl(block: CurlRequestConfig.() -> Unit) {
+    val config = getCapabilityOrNull(CurlRequestCapability)
+        ?: CurlRequestConfig().also { setCapability(CurlRequestCapability, it) }
+    config.block()
+}
@@ -0,0 +1,289 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl
+
+import io.ktor.client.*
+import io.ktor.client.request.*
+import io.ktor.client.statement.*
+import io.ktor.http.*
+import io.ktor.utils.io.*
+import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.channels.Channel
+import kotlinx.coroutines.coroutineScope
+import kotlinx.coroutines.launch
+import kotlinx.io.IOException
+import kotlinx.io.files.Path
+import kotlin.time.Duration
+import kotlin.time.DurationUnit
+import kotlin.time.TimeSource
+
+// A request is added while the previous one raised the overall throughput by at least 10%
+private const val MIN_THROUGHPUT_GAIN = 1.1
+
+// Keeps the throughput of a segment downloaded faster than the clock resolution finite
+private const val MIN_MEASURED_SECONDS = 1e-6
+
+/**
+ * Settings of [downloadSegmented].
+ *
+ * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlSegmentedDownloadConfig)
+ */
+@KtorDsl
+public class CurlSegmentedDownloadConfig {
+    internal var requestBlock: HttpRequestBuilder.() -> Unit = {}
+
+    /**
+     * The maximum number of segments downloaded at the same time.
+     * The download starts with two concurrent requests and adds one more each time the last one added
+     * raised the overall throughput, so a server or a network that doesn't scale gets no more requests than it uses.
+     * There are never more requests than segments left, so a small file is downloaded with fewer of them.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlSegmentedDownloadConfig.maxParallelism)
+     */
+    public var maxParallelism: Int = 8
+        set(value) {
+            require(value > 0) { "maxParallelism should be positive, but was $value" }
+            field = value
+        }
+
+    /**
+     * The size of a byte range requested at once.
+     * A file is split into more segments than [maxParallelism], so faster connections pick up more of them.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlSegmentedDownloadConfig.segmentSize)
+     */
+    public var segmentSize: Long = 8L * 1024 * 1024
+        set(value) {
+            require(value > 0) { "segmentSize should be positive, but was $value" }
+            field = value
+        }
+
+    /**
+     * The number of times a segment is requested again after a timeout or a broken connection
+     * before the whole download fails. An error response fails the download at once.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlSegmentedDownloadConfig.maxRetries)
+     */
+    public var maxRetries: Int = 3
+        set(value) {
+            require(value >= 0) { "maxRetries should not be negative, but was $value" }
+            field = value
+        }
+
+    /**
+     * Configures every segment request, for example, to add authorization headers.
+     *
+     * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlSegmentedDownloadConfig.request)
+     */
+    public fun request(block: HttpRequestBuilder.() -> Unit) {
+        requestBlock = block
+    }
+}
+
+/**
+ * Downloads the resource at [url] to the file at [path] in byte ranges fetched concurrently.
+ * Each range is written in place by the [Curl] engine, see [CurlRequestConfig.downloadPath].
+ *
+ * The first segment request reveals the resource size. If the server doesn't support ranges,
+ * it responds with the whole resource, and the download completes with that single response.
+ * If the server doesn't tell the size, the whole resource is requested again at once.
+ * The other segments are requested with an `If-Range` validator, so a resource changed in the middle
+ * of the download fails it instead of producing a mix of both versions.
+ * Segments are requested with `Accept-Encoding: identity`, since ranges of a compressed representation
+ * can't be decoded separately, and the body of an unsuccessful response is never written to the file.
+ * The content of the file is undefined if the download fails.
+ *
+ * ```kotlin
+ * val file = client.downloadSegmented("https://example.com/dataset.bin", Path("/data/dataset.bin")) {
+ *     maxParallelism = 16
+ * }
+ * ```
+ *
+ * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.downloadSegmented)
+ */
+public suspend fun HttpClient.downloadSegmented(
+    url: String,
+    path: Path,
+    block: CurlSegmentedDownloadConfig.() -> Unit = {}
+): CurlDownloadedFile {
+    val config = CurlSegmentedDownloadConfig().apply(block)
+
+    val firstStart = TimeSource.Monotonic.markNow()
+    val first = downloadSegmentWithRetries(url, path, 0 until config.segmentSize, validator = null, config)
+    if (first.status != HttpStatusCode.PartialContent) return first.file
+    val firstThroughput = throughput(first.file.size, firstStart.elapsedNow())
+
+    // Without the size the other ranges are unknown, so the resource is downloaded in a single request
+    val totalSize = first.totalSize
+        ?: return downloadSegmentWithRetries(url, path, range = null, validator = null, config).file
+    val segments = (config.segmentSize until totalSize step config.segmentSize).map { start ->
+        start until minOf(start + config.segmentSize, totalSize)
+    }
+    downloadSegments(url, path, segments, first.validator, firstThroughput, config)
+
+    return CurlDownloadedFile(path, totalSize)
+}
+
+/**
+ * Downloads the [segments] with a growing number of concurrent requests.
+ * The throughput of each number of requests is measured over as many completed segments,
+ * and one more request is added while it beats the previous number by [MIN_THROUGHPUT_GAIN].
+ * A single request is known to reach the [singleThroughput] of the first segment.
+ */
+private suspend fun HttpClient.downloadSegments(
+    url: String,
+    path: Path,
+    segments: List<LongRange>,
+    validator: String?,
+    singleThroughput: Double,
+    config: CurlSegmentedDownloadConfig
+) = coroutineScope {
+    val pending = Channel<LongRange>(Channel.UNLIMITED)
+    segments.forEach { pending.trySend(it) }
+    pending.close()
+    // The sizes of the downloaded segments, received by this coroutine only
+    val completed = Channel<Long>(Channel.UNLIMITED)
+
+    var workers = 0
+    fun addWorker() {
+        workers++
+        launch {
+            for (range in pending) {
+                downloadSegmentWithRetries(url, path, range, validator, config)
+                completed.send(range.last - range.first + 1)
+            }
+        }
+    }
+
+    var isGrowing = config.maxParallelism > 1
+    var previousThroughput = singleThroughput
+    var windowStart = TimeSource.Monotonic.markNow()
+    var windowBytes = 0L
+    var windowSegments = 0
+    addWorker()
+    if (isGrowing) addWorker()
+
+    repeat(segments.size) {
+        windowBytes += completed.receive()
+        if (!isGrowing || ++windowSegments < workers) return@repeat
+
+        val throughput = throughput(windowBytes, windowStart.elapsedNow())
+        isGrowing = throughput >= previousThroughput * MIN_THROUGHPUT_GAIN && workers < config.maxParallelism
+        if (isGrowing) {
+            previousThroughput = throughput
+            windowStart = TimeSource.Monotonic.markNow()
+            windowBytes = 0
+            windowSegments = 0
+            addWorker()
+        }
+    }
+}
+
+private fun throughput(bytes: Long, time: Duration): Double =
+    bytes / time.toDouble(DurationUnit.SECONDS).coerceAtLeast(MIN_MEASURED_SECONDS)
+
+private class SegmentResult(
+    val status: HttpStatusCode,
+    val file: CurlDownloadedFile,
+    val totalSize: Long?,
+    val validator: String?,
+)
+
+/**
+ * Thrown when the server responds to a segment request with an error or other content,
+ * so requesting it again doesn't help.
+ */
+private class SegmentResponseException(message: String) : IllegalStateException(message)
+
+/**
+ * Downloads the [range] again after an [IOException], such as a timeout, up to [CurlSegmentedDownloadConfig.maxRetries]
+ * times. Any other failure, such as an error response, is thrown at once.
+ */
+private suspend fun HttpClient.downloadSegmentWithRetries(
+    url: String,
+    path: Path,
+    range: LongRange?,
+    validator: String?,
+    config: CurlSegmentedDownloadConfig
+): SegmentResult {
+    var retry = 0
+    while (true) {
+        try {
+            return downloadSegment(url, path, range, validator, config)
+        } catch (cause: IOException) {
+            if (retry++ >= config.maxRetries) throw cause
+        }
+    }
+}
+
+/**
+ * Downloads the [range] of the resource to its place in the file, or the whole resource if the [range] is `null`.
+ */
+private suspend fun HttpClient.downloadSegment(
+    url: String,
+    path: Path,
+    range: LongRange?,
+    validator: String?,
+    config: CurlSegmentedDownloadConfig
+): SegmentResult = try {
+    executeSegmentRequest(url, path, range, validator, config)
+} catch (cause: CancellationException) {
+    throw cause
+} catch (cause: SegmentResponseException) {
+    throw cause
+} catch (cause: IllegalStateException) {
+    // The Curl engine reports a broken connection or an interrupted body as an IllegalStateException
+    throw IOException("Failed to download ${range.describe()} of $url", cause)
+}
+
+private suspend fun HttpClient.executeSegmentRequest(
+    url: String,
+    path: Path,
+    range: LongRange?,
+    validator: String?,
+    config: CurlSegmentedDownloadConfig
+): SegmentResult = prepareGet(url) {
+    config.requestBlock(this)
+    range?.let { header(HttpHeaders.Range, "bytes=${it.first}-${it.last}") }
+    validator?.let { header(HttpHeaders.IfRange, it) }
+    // Byte ranges of a compressed representation can't be decoded separately
+    header(HttpHeaders.AcceptEncoding, "identity")
+    curl {
+        downloadPath = path
+        downloadOffset = range?.first ?: 0L
+    }
+}.execute { response ->
+    if (!response.status.isSuccess()) {
+        throw SegmentResponseException("Failed to download ${range.describe()} of $url: ${response.status}")
+    }
+    val file = response.downloadedFile()
+
+    // The first segment may get the whole resource, any other must get exactly the requested range
+    val isFirst = range == null || range.first == 0L
+    val contentRange = response.headers[HttpHeaders.ContentRange]?.let(::parseContentRange)
+    if (!isFirst && (response.status != HttpStatusCode.PartialContent || contentRange?.first != range?.first)) {
+        throw SegmentResponseException("$url changed while its ${range.describe()} were downloaded")
+    }
+
+    SegmentResult(
+        status = response.status,
+        file = file,
+        totalSize = contentRange?.second,
+        validator = response.headers[HttpHeaders.ETag]?.takeUnless { it.startsWith("W/") }
+            ?: response.headers[HttpHeaders.LastModified],
+    )
+}
+
+private fun LongRange?.describe(): String = this?.let { "bytes ${it.first}-${it.last}" } ?: "all bytes"
+
+/**
+ * Parses `bytes <first>-<last>/<total>` into the first byte position and the total size, if it is known.
+ */
+private fun parseContentRange(value: String): Pair<Long, Long?>? {
+    val spec = value.trim().removePrefix("bytes").trim()
+    val first = spec.substringBefore('-').toLongOrNull() ?: return null
+    val total = spec.substringAfter('/', "").toLongOrNull()
+    return first to total
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl
+
+import io.ktor.client.statement.*
+import io.ktor.http.*
+import io.ktor.util.*
+import kotlinx.coroutines.CompletableDeferred
+
+internal val ResponseTrailersKey = AttributeKey<CompletableDeferred<Headers>>("CurlResponseTrailers")
+
+/**
+ * Waits until the response body is received and returns the trailer fields sent after it.
+ * Returns empty headers if the server sent no trailers.
+ *
+ * The trailers arrive after the whole body, so read the body first:
+ * waiting for the trailers of an unread large body never completes.
+ *
+ * ```kotlin
+ * client.prepareGet("https://example.com/archive.tar").execute { response ->
+ *     response.bodyAsChannel().copyAndClose(output)
+ *     val checksum = response.trailers()["X-Checksum"]
+ * }
+ * ```
+ *
+ * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.trailers)
+ *
+ * @throws IllegalStateException if the response body wasn't received by the [Curl] engine as a stream.
+ */
+public suspend fun HttpResponse.trailers(): Headers {
+    val trailers = call.request.attributes.getOrNull(ResponseTrailersKey)
+    checkNotNull(trailers) { "Trailers of ${call.request.url} aren't available" }
+    return trailers.await()
+}
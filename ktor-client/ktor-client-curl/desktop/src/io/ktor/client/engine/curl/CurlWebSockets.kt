@@ -0,0 +1,96 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl
+
+import io.ktor.client.engine.curl.internal.*
+import io.ktor.client.plugins.websocket.*
+import io.ktor.util.*
+import io.ktor.utils.io.*
+import io.ktor.websocket.*
+import kotlinx.coroutines.channels.ReceiveChannel
+import kotlinx.io.Source
+
+internal val WebSocketSessionKey = AttributeKey<CurlWebSocketSession>("CurlWebSocketSession")
+
+/**
+ * Sends a single [frameType] frame with a payload of [length] bytes read from the [content],
+ * so a large message is sent in bounded memory instead of being held in a [Frame] as a whole.
+ * Frames sent to [WebSocketSession.outgoing] meanwhile are sent before or after this frame.
+ * The payload is sent as is, extensions such as [WebSocketDeflateExtension] don't process it.
+ *
+ * ```kotlin
+ * client.webSocket("wss://example.com/upload") {
+ *     val path = Path("video.mp4")
+ *     val size = SystemFileSystem.metadataOrNull(path)!!.size
+ *     SystemFileSystem.source(path).buffered().use { sendFrame(FrameType.BINARY, it, size) }
+ * }
+ * ```
+ *
+ * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.sendFrame)
+ *
+ * @param frameType [FrameType.TEXT] or [FrameType.BINARY].
+ * @throws IllegalStateException if the session wasn't opened by the [Curl] engine.
+ * @throws kotlinx.io.EOFException if the [content] ends before [length] bytes,
+ * the session is closed in this case, as the peer waits for the rest of the frame.
+ */
+public suspend fun ClientWebSocketSession.sendFrame(frameType: FrameType, content: ByteReadChannel, length: Long) {
+    val session = call.request.attributes.getOrNull(WebSocketSessionKey)
+    checkNotNull(session) { "WebSocket session of ${call.request.url} isn't opened by the Curl engine" }
+    session.sendStreamed(frameType, content, length)
+}
+
+/**
+ * Sends a single [frameType] frame with a payload of [length] bytes read from the [content].
+ * See the [ByteReadChannel] overload for details.
+ *
+ * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.sendFrame)
+ */
+public suspend fun ClientWebSocketSession.sendFrame(frameType: FrameType, content: Source, length: Long) {
+    sendFrame(frameType, ByteReadChannel(content), length)
+}
+
+/**
+ * A WebSocket message received with [CurlRequestConfig.streamWebSocketMessages].
+ * The [content] of a fragmented message continues across all its frames and is closed at the end of the message.
+ * Receiving is paused while the [content] is full, so a message that is neither read nor cancelled
+ * holds back the following messages and control frames.
+ *
+ * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.CurlWebSocketMessage)
+ *
+ * @property frameType [FrameType.TEXT] or [FrameType.BINARY].
+ * @property content the payload of the message, which is received as it is read.
+ */
+public class CurlWebSocketMessage internal constructor(
+    public val frameType: FrameType,
+    public val content: ByteReadChannel,
+) {
+    override fun toString(): String = "CurlWebSocketMessage(frameType=$frameType)"
+}
+
+/**
+ * The data messages of a session opened with [CurlRequestConfig.streamWebSocketMessages],
+ * which are delivered here instead of [WebSocketSession.incoming].
+ * The channel is closed when the session is closed.
+ *
+ * ```kotlin
+ * client.webSocket("wss://example.com/files", request = { curl { streamWebSocketMessages = true } }) {
+ *     val message = incomingMessages.receive()
+ *     SystemFileSystem.sink(Path("video.mp4")).buffered().use { message.content.readTo(it) }
+ * }
+ * ```
+ *
+ * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.incomingMessages)
+ *
+ * @throws IllegalStateException if the session wasn't opened by the [Curl] engine with streamed messages.
+ */
+public val ClientWebSocketSession.incomingMessages: ReceiveChannel<CurlWebSocketMessage>
+    get() {
+        val session = call.request.attributes.getOrNull(WebSocketSessionKey)
+        checkNotNull(session) { "WebSocket session of ${call.request.url} isn't opened by the Curl engine" }
+        return checkNotNull(session.incomingMessages) {
+            "WebSocket session of ${call.request.url} doesn't stream messages, " +
+                "see CurlRequestConfig.streamWebSocketMessages"
+        }
+    }
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl
+
+import io.ktor.client.request.forms.*
+import io.ktor.http.*
+import io.ktor.http.content.*
+import io.ktor.utils.io.*
+import kotlinx.io.buffered
+import kotlinx.io.files.*
+
+/**
+ * OutgoingContent representing a local file at [path] with a specified [contentType].
+ *
+ * The [Curl] engine uploads the file straight from disk on the curl thread,
+ * without copying it through a [ByteReadChannel]. Other engines and plugins read it with [readFrom].
+ *
+ * ```kotlin
+ * client.put("https://example.com/upload/backup.tar") {
+ *     setBody(LocalFileContent(Path("/var/backups/backup.tar")))
+ * }
+ * ```
+ *
+ * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.LocalFileContent)
+ *
+ * @param path specifies the file to be sent to a server
+ */
+public class LocalFileContent(
+    public val path: Path,
+    override val contentType: ContentType = ContentType.defaultForFilePath(path.name)
+) : OutgoingContent.ReadChannelContent() {
+
+    override val contentLength: Long?
+        get() = SystemFileSystem.metadataOrNull(path)?.size?.takeIf { it >= 0 }
+
+    override fun readFrom(): ByteReadChannel = ByteReadChannel(SystemFileSystem.source(path).buffered())
+}
+
+/**
+ * Appends a file part with the specified [key] reading the local file at [path].
+ * The `filename` and `Content-Type` of the part are derived from the [path] unless set in [headers].
+ *
+ * The [Curl] engine passes the file to libcurl, which streams it from disk on the curl thread.
+ * Other engines read it as a regular [ChannelProvider] part.
+ *
+ * ```kotlin
+ * client.submitFormWithBinaryData(
+ *     url = "https://example.com/upload",
+ *     formData = formData {
+ *         append("description", "Nightly backup")
+ *         appendFile("archive", Path("/var/backups/backup.tar"))
+ *     }
+ * )
+ * ```
+ *
+ * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.client.engine.curl.appendFile)
+ */
+public fun FormBuilder.appendFile(key: String, path: Path, headers: Headers = Headers.Empty) {
+    val partHeaders = Headers.build {
+        appendAll(headers)
+        if (!headers.contains(HttpHeaders.ContentDisposition)) {
+            append(HttpHeaders.ContentDisposition, "filename=${path.name.quote()}")
+        }
+        if (!headers.contains(HttpHeaders.ContentType)) {
+            append(HttpHeaders.ContentType, ContentType.defaultForFilePath(path.name).toString())
+        }
+    }
+    val size = SystemFileSystem.metadataOrNull(path)?.size?.takeIf { it >= 0 }
+    append(key, ChannelProvider(size, LocalFileChannelProvider(path)), partHeaders)
+}
+
+/**
+ * Opens the file at [path], the [Curl] engine recognizes it to let libcurl read the file instead.
+ */
+internal class LocalFileChannelProvider(val path: Path) : () -> ByteReadChannel {
+    override fun invoke(): ByteReadChannel = ByteReadChannel(SystemFileSystem.source(path).buffered())
+}
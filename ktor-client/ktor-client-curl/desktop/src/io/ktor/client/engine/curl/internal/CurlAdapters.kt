@@ -28,6 +28,11 @@ internal val DISALLOWED_WEBSOCKET_HEADERS = setOf(
     HttpHeaders.SecWebSocketKey
 )
 
+/**
+ * libcurl generates these headers for a `CURLOPT_MIMEPOST` body with its own boundary.
+ */
+private val MIME_POST_HEADERS = setOf(HttpHeaders.ContentType.lowercase(), HttpHeaders.ContentLength.lowercase())
+
 internal fun CURLMcode.verify() {
     check(this == CURLM_OK) { "Unexpected curl verify: $errorMessage" }
 }
@@ -177,13 +182,60 @@ internal fun EasyHandle.getInfo(info: CURLINFO, optionValue: CPointer<*>) {
     curl_easy_getinfo(this, info, optionValue).verify()
 }
 
+/**
+ * Returns the value of the last [name] header of the last response received by this handle.
+ */
+internal fun EasyHandle.responseHeader(name: String): String? = memScoped {
+    val header = alloc<CPointerVar<curl_header>>()
+    val result = curl_easy_header(this@responseHeader, name, 0.convert(), CURLH_HEADER.convert(), -1, header.ptr)
+    if (result != CURLHE_OK) return@memScoped null
+    header.value?.pointed?.value?.toKString()
+}
+
+/**
+ * Returns the trailer fields of the last response received by this handle.
+ */
+internal fun EasyHandle.responseTrailers(): Headers {
+    var trailer = curl_easy_nextheader(this, CURLH_TRAILER.convert(), -1, null) ?: return Headers.Empty
+    return Headers.build {
+        while (true) {
+            val field = trailer.pointed
+            append(field.name!!.toKString(), field.value?.toKString().orEmpty())
+            trailer = curl_easy_nextheader(this@responseTrailers, CURLH_TRAILER.convert(), -1, trailer) ?: break
+        }
+    }
+}
+
+/**
+ * Copies the header list, so the copy can outlive the original, and appends the [extraHeaders].
+ */
+internal fun CPointer<curl_slist>.copyWith(vararg extraHeaders: String): CPointer<curl_slist> {
+    var result: CPointer<curl_slist>? = null
+    var node: CPointer<curl_slist>? = this
+    while (node != null) {
+        node.pointed.data?.let { result = curl_slist_append(result, it.toKString()) }
+        node = node.pointed.next
+    }
+    for (header in extraHeaders) {
+        result = curl_slist_append(result, header)
+    }
+    return result!!
+}
+
 @OptIn(InternalAPI::class, ExperimentalForeignApi::class)
-internal fun HttpRequestData.headersToCurl(): CPointer<curl_slist> {
+internal fun HttpRequestData.headersToCurl(
+    skipContentHeaders: Boolean = false,
+    skipWebSocketExtensions: Boolean = false,
+): CPointer<curl_slist> {
     var result: CPointer<curl_slist>? = null
 
     val isUpgradeRequest = isUpgradeRequest()
     forEachHeader { key, value ->
         if (isUpgradeRequest && key in DISALLOWED_WEBSOCKET_HEADERS) return@forEachHeader
+        if (skipWebSocketExtensions && key.equals(HttpHeaders.SecWebSocketExtensions, ignoreCase = true)) {
+            return@forEachHeader
+        }
+        if (skipContentHeaders && key.lowercase() in MIME_POST_HEADERS) return@forEachHeader
         val header = "$key: $value"
         result = curl_slist_append(result, header)
     }
@@ -12,6 +12,9 @@ import kotlinx.cinterop.*
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.launch
 import kotlinx.io.Buffer
+import libcurl.CURL_TRAILERFUNC_OK
+import libcurl.curl_slist
+import libcurl.curl_slist_append
 import platform.posix.size_t
 import kotlin.coroutines.CoroutineContext
 
@@ -65,9 +68,21 @@ internal fun onBodyChunkRequested(
     dataRef: COpaquePointer,
 ): size_t {
     val wrapper: CurlRequestBodyData = dataRef.fromCPointer()
-    val body = wrapper.body
     val requested = (size * count).toInt()
 
+    wrapper.streamedBody?.let { streamedBody ->
+        val readCount = try {
+            streamedBody.readTo(buffer, requested, wrapper.onUnpause)
+        } catch (_: Throwable) {
+            return READFUNC_ABORT
+        }
+        if (readCount != null) return readCount.convert()
+        wrapper.onPause()
+        return READFUNC_PAUSE
+    }
+
+    val body = wrapper.body
+
     if (body.isClosedForRead) {
         return if (body.closedCause != null) READFUNC_ABORT else 0.convert()
     }
@@ -91,13 +106,40 @@ internal fun onBodyChunkRequested(
             wrapper.onUnpause()
         }
     }
+    wrapper.onPause()
     return READFUNC_PAUSE
 }
 
+/**
+ * Provides the request trailers once the body is sent.
+ *
+ * @see <a href="https://curl.se/libcurl/c/CURLOPT_TRAILERFUNCTION.html">Description.</a>
+ */
+@OptIn(ExperimentalForeignApi::class)
+internal fun onTrailersRequested(
+    list: CPointer<CPointerVar<curl_slist>>?,
+    dataRef: COpaquePointer?,
+): Int {
+    val wrapper: CurlRequestBodyData = dataRef!!.fromCPointer()
+    val trailers = wrapper.streamedBody?.trailers ?: return CURL_TRAILERFUNC_OK
+
+    // libcurl frees the list after sending it
+    var result: CPointer<curl_slist>? = null
+    trailers.forEach { name, values ->
+        for (value in values) {
+            result = curl_slist_append(result, "$name: $value")
+        }
+    }
+    list!!.pointed.value = result
+    return CURL_TRAILERFUNC_OK
+}
+
 internal class CurlRequestBodyData(
     val body: ByteReadChannel,
     val callContext: CoroutineContext,
-    val onUnpause: () -> Unit
+    val onPause: () -> Unit,
+    val onUnpause: () -> Unit,
+    val streamedBody: CurlRequestBodyChannel? = null,
 )
 
 internal interface CurlResponseBodyData {
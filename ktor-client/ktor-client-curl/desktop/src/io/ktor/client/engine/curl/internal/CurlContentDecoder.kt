@@ -0,0 +1,103 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.internal
+
+import io.ktor.utils.io.*
+import kotlinx.cinterop.*
+import kotlinx.coroutines.DelicateCoroutinesApi
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.GlobalScope
+import kotlinx.io.EOFException
+import platform.zlib.*
+import kotlin.coroutines.CoroutineContext
+
+private const val DECODER_BUFFER_SIZE = 8192
+
+// Window bits with +32 make zlib detect both gzip and zlib headers
+private const val AUTO_DETECT_WINDOW_BITS = MAX_WBITS + 32
+
+// Negative window bits make zlib read raw deflate data without a header
+private const val RAW_DEFLATE_WINDOW_BITS = -MAX_WBITS
+
+/**
+ * Content encodings that can be decoded by [decodeContentOffThread].
+ */
+internal val OFFLOADED_CONTENT_ENCODINGS = setOf("gzip", "x-gzip", "deflate")
+
+/**
+ * Decodes the [encoded] body on [Dispatchers.Default], so inflating large responses
+ * doesn't block the curl dispatcher thread serving all other transfers.
+ * Like libcurl, it accepts `deflate` content without the zlib header and fails on a truncated stream.
+ */
+@OptIn(DelicateCoroutinesApi::class)
+internal fun decodeContentOffThread(encoded: ByteReadChannel, callContext: CoroutineContext): ByteReadChannel =
+    GlobalScope.writer(callContext + Dispatchers.Default) {
+        inflateContent(encoded, channel)
+    }.channel
+
+@OptIn(ExperimentalForeignApi::class)
+private suspend fun inflateContent(source: ByteReadChannel, destination: ByteWriteChannel) = memScoped {
+    val stream = alloc<z_stream>().apply {
+        zalloc = null
+        zfree = null
+        opaque = null
+    }
+    val initResult = inflateInit2_(
+        stream.ptr,
+        AUTO_DETECT_WINDOW_BITS,
+        zlibVersion()?.toKString(),
+        sizeOf<z_stream>().toInt()
+    )
+    check(initResult == Z_OK) { "Failed to initialize content decoder: $initResult" }
+
+    val input = ByteArray(DECODER_BUFFER_SIZE)
+    val output = ByteArray(DECODER_BUFFER_SIZE)
+    try {
+        var received = false
+        var finished = false
+        while (!finished) {
+            val read = source.readAvailable(input)
+            if (read == -1) break
+            if (read == 0) continue
+
+            input.usePinned { inputPinned ->
+                output.usePinned { outputPinned ->
+                    stream.next_in = inputPinned.addressOf(0).reinterpret()
+                    stream.avail_in = read.convert()
+
+                    do {
+                        stream.next_out = outputPinned.addressOf(0).reinterpret()
+                        stream.avail_out = output.size.convert()
+
+                        var result = inflate(stream.ptr, Z_NO_FLUSH)
+                        if (result == Z_DATA_ERROR && !received && stream.total_out.toLong() == 0L) {
+                            // Some servers send `deflate` content without the zlib header, libcurl accepts it as well
+                            check(inflateReset2(stream.ptr, RAW_DEFLATE_WINDOW_BITS) == Z_OK)
+                            stream.next_in = inputPinned.addressOf(0).reinterpret()
+                            stream.avail_in = read.convert()
+                            result = inflate(stream.ptr, Z_NO_FLUSH)
+                        }
+                        check(result == Z_OK || result == Z_STREAM_END || result == Z_BUF_ERROR) {
+                            "Malformed encoded content: ${stream.msg?.toKString() ?: result}"
+                        }
+                        received = true
+
+                        val decoded = output.size - stream.avail_out.toInt()
+                        if (decoded > 0) destination.writeFully(output, 0, decoded)
+                        finished = result == Z_STREAM_END
+                    } while (!finished && stream.avail_out.toInt() == 0)
+                }
+            }
+            destination.flush()
+        }
+
+        // An empty body has nothing to decode, but a started stream has to be complete
+        if (received && !finished) {
+            throw EOFException("Encoded content ended before the end of the compressed stream")
+        }
+    } finally {
+        inflateEnd(stream.ptr)
+    }
+}
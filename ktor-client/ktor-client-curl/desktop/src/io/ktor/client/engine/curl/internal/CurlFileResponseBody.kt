@@ -0,0 +1,107 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.internal
+
+import io.ktor.client.engine.curl.*
+import io.ktor.client.engine.curl.internal.Libcurl.WRITEFUNC_ERROR
+import io.ktor.utils.io.*
+import kotlinx.cinterop.*
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.io.IOException
+import kotlinx.io.files.Path
+import libcurl.CURLINFO_CONTENT_LENGTH_DOWNLOAD_T
+import libcurl.CURLINFO_RESPONSE_CODE
+import libcurl.curl_off_tVar
+import platform.posix.FILE
+import platform.posix.fclose
+import platform.posix.fwrite
+import platform.posix.size_t
+
+/**
+ * Writes the response body to the file at [path] from [offset] right on the curl thread.
+ *
+ * [bodyChannel] receives no data and is closed once the file is complete,
+ * so reading the response body waits for the download to finish.
+ * The body of a response with an unsuccessful status is passed to the [errorBody] instead,
+ * so the file is left untouched and the error body can still be read from [bodyChannel].
+ */
+@OptIn(ExperimentalForeignApi::class)
+internal class CurlFileResponseBody(
+    private val easyHandle: EasyHandle,
+    private val path: String,
+    private val offset: Long,
+    private val errorBody: CurlHttpResponseBody,
+) : CurlResponseBodyData {
+
+    val bodyChannel: ByteReadChannel
+        get() = errorBody.bodyChannel
+
+    val downloadedFile = CompletableDeferred<CurlDownloadedFile>()
+
+    private var file: CPointer<FILE>? = null
+    private var written = 0L
+
+    override fun onBodyChunkReceived(buffer: CPointer<ByteVar>, size: size_t, count: size_t): size_t {
+        val chunkSize = size * count
+        if (file == null && isUnsuccessful()) return errorBody.onBodyChunkReceived(buffer, size, count)
+
+        val file = file ?: openFile(expectedSize = contentLength()) ?: return WRITEFUNC_ERROR
+        val chunkWritten = fwrite(buffer, 1.convert(), chunkSize, file)
+        written += chunkWritten.toLong()
+        return if (chunkWritten == chunkSize) chunkSize else WRITEFUNC_ERROR
+    }
+
+    override fun close(cause: Throwable?) {
+        if (errorBody.bodyChannel.isClosedForWrite) return
+
+        if (file == null && isUnsuccessful()) {
+            val failure = cause
+                ?: IllegalStateException("The body of the response with status ${responseCode()} wasn't written to $path")
+            downloadedFile.completeExceptionally(failure)
+            errorBody.close(cause)
+            return
+        }
+
+        var failure = cause
+        // An empty body still produces an empty file
+        if (failure == null && file == null && openFile(expectedSize = 0) == null) {
+            failure = IOException("Failed to open $path")
+        }
+        file?.let {
+            // A decoded or failed body may end before the preallocated size, a range of a larger file is kept as is
+            if (offset == 0L) trimDownloadFile(it, written)
+            if (fclose(it) != 0 && failure == null) failure = IOException("Failed to write $path")
+        }
+        file = null
+
+        if (failure == null) {
+            downloadedFile.complete(CurlDownloadedFile(Path(path), written))
+        } else {
+            downloadedFile.completeExceptionally(failure)
+        }
+        errorBody.close(failure)
+    }
+
+    private fun openFile(expectedSize: Long): CPointer<FILE>? {
+        val file = openDownloadFile(path, offset) ?: return null
+        prepareDownloadFile(file, offset, expectedSize)
+        this.file = file
+        return file
+    }
+
+    private fun isUnsuccessful(): Boolean = responseCode() !in 200L..299L
+
+    private fun responseCode(): Long = memScoped {
+        val responseCode = alloc<LongVar>()
+        easyHandle.getInfo(CURLINFO_RESPONSE_CODE, responseCode.ptr)
+        responseCode.value
+    }
+
+    private fun contentLength(): Long = memScoped {
+        val contentLength = alloc<curl_off_tVar>()
+        easyHandle.getInfo(CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, contentLength.ptr)
+        contentLength.value
+    }
+}
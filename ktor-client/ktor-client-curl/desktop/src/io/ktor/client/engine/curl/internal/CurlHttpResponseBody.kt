@@ -6,12 +6,14 @@ package io.ktor.client.engine.curl.internal
 
 import io.ktor.client.engine.curl.internal.Libcurl.WRITEFUNC_ERROR
 import io.ktor.client.engine.curl.internal.Libcurl.WRITEFUNC_PAUSE
+import io.ktor.http.*
 import io.ktor.utils.io.*
 import io.ktor.utils.io.core.*
 import kotlinx.cinterop.ByteVar
 import kotlinx.cinterop.CPointer
 import kotlinx.cinterop.ExperimentalForeignApi
 import kotlinx.cinterop.convert
+import kotlinx.coroutines.CompletableDeferred
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Job
 import kotlinx.coroutines.cancel
@@ -22,7 +24,8 @@ import kotlin.coroutines.CoroutineContext
 
 internal class CurlHttpResponseBody(
     callContext: Job,
-    private val onUnpause: () -> Unit,
+    var onPause: () -> Unit,
+    var onUnpause: () -> Unit,
 ) : CurlResponseBodyData, CoroutineScope {
 
     private val job = Job(callContext)
@@ -32,20 +35,35 @@ internal class CurlHttpResponseBody(
         attachJob(job)
     }
 
+    /**
+     * The trailer fields received after the body, completed once the transfer is complete.
+     */
+    val trailers = CompletableDeferred<Headers>()
+
     @Volatile
     private var paused = false
 
+    /**
+     * The number of body bytes passed to [bodyChannel], a resumed transfer continues from this position.
+     */
+    var bytesReceived: Long = 0
+        private set
+
     @OptIn(ExperimentalForeignApi::class, InternalAPI::class)
     override fun onBodyChunkReceived(buffer: CPointer<ByteVar>, size: size_t, count: size_t): size_t {
         if (bodyChannel.isClosedForWrite) {
             return if (bodyChannel.closedCause != null) WRITEFUNC_ERROR else 0.convert()
         }
-        if (paused) return WRITEFUNC_PAUSE
+        if (paused) {
+            onPause()
+            return WRITEFUNC_PAUSE
+        }
 
         val chunkSize = (size * count).toLong()
         return try {
             bodyChannel.writeBuffer.writeFully(buffer, 0L, chunkSize)
             bodyChannel.flushWriteBuffer()
+            bytesReceived += chunkSize
             if (!bodyChannel.hasFreeSpace) pauseUntilFreeSpaceAvailable()
             chunkSize.convert()
         } catch (_: Throwable) {
@@ -70,6 +88,7 @@ internal class CurlHttpResponseBody(
     }
 
     override fun close(cause: Throwable?) {
+        if (cause == null) trailers.complete(Headers.Empty) else trailers.completeExceptionally(cause)
         if (bodyChannel.isClosedForWrite) return
         bodyChannel.close(cause)
         cancel(cause as? CancellationException ?: CancellationException(cause))
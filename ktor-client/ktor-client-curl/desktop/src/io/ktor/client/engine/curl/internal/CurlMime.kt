@@ -0,0 +1,57 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.internal
+
+import io.ktor.client.engine.curl.*
+import io.ktor.client.request.forms.*
+import io.ktor.http.*
+import io.ktor.http.content.*
+import io.ktor.utils.io.*
+
+/**
+ * A part of a `multipart/form-data` body built by libcurl with the `curl_mime` API.
+ * [headers] are complete header lines, so libcurl doesn't generate its own `Content-Disposition`.
+ */
+internal sealed class CurlMimePart(val headers: List<String>) {
+    class Data(headers: List<String>, val value: String) : CurlMimePart(headers)
+
+    /**
+     * A file read by libcurl from disk on the curl thread.
+     */
+    class File(headers: List<String>, val path: String) : CurlMimePart(headers)
+
+    /**
+     * Data read from [channel] with a read callback, [size] is `-1` if unknown.
+     */
+    class Stream(headers: List<String>, val channel: ByteReadChannel, val size: Long) : CurlMimePart(headers)
+}
+
+/**
+ * Returns the parts of a `multipart/form-data` body, so libcurl can build it without serializing it in a channel.
+ * Other multipart subtypes are sent as is.
+ */
+@OptIn(InternalAPI::class)
+internal fun OutgoingContent.toCurlMimeParts(): List<CurlMimePart>? = when (this) {
+    is MultiPartFormDataContent -> {
+        if (contentType.match(ContentType.MultiPart.FormData)) parts.map { it.toCurlMimePart() } else null
+    }
+
+    is OutgoingContent.ContentWrapper -> delegate().toCurlMimeParts()
+    else -> null
+}
+
+private fun PartData.toCurlMimePart(): CurlMimePart {
+    val headerLines = headers.entries().map { (name, values) -> "$name: ${values.joinToString("; ")}" }
+    val size = headers[HttpHeaders.ContentLength]?.toLongOrNull() ?: -1L
+    return when (this) {
+        is PartData.FormItem -> CurlMimePart.Data(headerLines, value)
+        is PartData.BinaryItem -> CurlMimePart.Stream(headerLines, ByteReadChannel(provider()), size)
+        is PartData.FileItem -> CurlMimePart.Stream(headerLines, provider(), size)
+        is PartData.BinaryChannelItem -> when (val provider = provider) {
+            is LocalFileChannelProvider -> CurlMimePart.File(headerLines, provider.path.toString())
+            else -> CurlMimePart.Stream(headerLines, provider(), size)
+        }
+    }
+}
@@ -5,37 +5,94 @@
 package io.ktor.client.engine.curl.internal
 
 import io.ktor.client.engine.*
+import io.ktor.client.network.sockets.SocketTimeoutException
 import io.ktor.client.plugins.*
 import io.ktor.client.plugins.websocket.*
+import io.ktor.http.HttpHeaders
+import io.ktor.http.HttpStatusCode
+import io.ktor.http.URLProtocol
 import io.ktor.utils.io.*
 import io.ktor.utils.io.core.*
 import io.ktor.utils.io.locks.*
 import kotlinx.cinterop.*
 import kotlinx.coroutines.CompletableDeferred
-import kotlinx.coroutines.CompletableJob
+import kotlinx.io.IOException
 import kotlinx.io.readByteArray
 import libcurl.*
+import platform.posix.FILE
+import platform.posix.fclose
+import platform.posix.fopen
 import platform.posix.getenv
 import platform.posix.size_tVar
 
+// Larger buffers than the libcurl defaults mean fewer syscalls when a body is read from or written to disk
+private const val FILE_TRANSFER_BUFFER_SIZE = 512 * 1024L
+
+// Connection failures in the middle of a response body, the rest of the body can still be requested
+private val INTERRUPTED_BODY_ERRORS = setOf(CURLE_PARTIAL_FILE, CURLE_RECV_ERROR)
+
+/**
+ * A transfer continuing the [body] of a failed response from [offset], see [CurlRequestData.maxResumeAttempts].
+ * [headers] are the request headers with `If-Range` added.
+ */
+@OptIn(ExperimentalForeignApi::class)
+private class ResumedTransfer(
+    val body: CurlHttpResponseBody,
+    val offset: Long,
+    val headers: CPointer<curl_slist>,
+    val attempt: Int,
+)
+
 @OptIn(ExperimentalForeignApi::class)
 private class RequestHolder(
     val responseCompletable: CompletableDeferred<CurlSuccess>,
     val requestHeaders: CPointer<curl_slist>,
     val responseDataRef: StableRef<CurlResponseBuilder>,
-    val requestWrapper: StableRef<CurlRequestBodyData>,
+    val requestWrapper: StableRef<CurlRequestBodyData>?,
     val responseWrapper: StableRef<CurlResponseBodyData>,
+    val inMemoryContent: Pinned<ByteArray>?,
+    val resumeAttempt: Int,
 ) {
+    var uploadFile: CPointer<FILE>? = null
+    var mime: CPointer<curl_mime>? = null
+    val mimeStreams = mutableListOf<StableRef<CurlRequestBodyData>>()
+
+    /**
+     * The `CURLPAUSE_*` bits of the directions paused by the callbacks, accessed on the curl thread only.
+     */
+    var pausedDirections: Int = CURLPAUSE_CONT
+
+    /**
+     * The `CURLOPT_MAX_*_SPEED_LARGE` values set on the handle, where `0` is no limit, accessed on the curl thread only.
+     */
+    var sendSpeedLimit: Long = 0
+    var receiveSpeedLimit: Long = 0
+
+    val request: CurlRequestData
+        get() = responseDataRef.get().request
+
     fun dispose() {
+        // Stops a producer of a body that libcurl won't read anymore, a completely sent body is already closed
+        request.streamedContent?.cancel(IOException("Request body was not sent completely"))
         curl_slist_free_all(requestHeaders)
         responseDataRef.dispose()
-        requestWrapper.dispose()
+        requestWrapper?.dispose()
         responseWrapper.dispose()
+        inMemoryContent?.unpin()
+        uploadFile?.let { fclose(it) }
+        curl_mime_free(mime)
+        mimeStreams.forEach { it.dispose() }
     }
 }
 
 @OptIn(InternalAPI::class, ExperimentalForeignApi::class)
-internal class CurlMultiApiHandler : Closeable {
+internal class CurlMultiApiHandler(
+    private val maxTotalSendSpeed: Long? = null,
+    private val maxTotalReceiveSpeed: Long? = null,
+    webSocketPingIntervalMillis: Long? = null,
+    private val webSocketPingTimeoutMillis: Long = 15_000,
+    private val webSocketAutoPong: Boolean = true,
+) : Closeable {
     private val activeHandles = mutableMapOf<EasyHandle, RequestHolder>()
     private val cancelledHandles = mutableSetOf<Pair<EasyHandle, Throwable>>()
 
@@ -43,7 +100,33 @@ internal class CurlMultiApiHandler : Closeable {
         ?: throw RuntimeException("Could not initialize curl multi handle")
 
     private val easyHandlesToUnpauseLock = SynchronizedObject()
-    private val easyHandlesToUnpause = mutableListOf<EasyHandle>()
+    private val easyHandlesToUnpause = mutableListOf<Pair<EasyHandle, Int>>()
+
+    private val webSocketsToSendLock = SynchronizedObject()
+    private val webSocketsToSend = mutableListOf<CurlWebSocketResponseBody>()
+
+    /**
+     * WebSockets with queued frames, accessed on the curl thread only.
+     * A WebSocket stays here until libcurl takes all its frames.
+     */
+    private val sendingWebSockets = mutableSetOf<CurlWebSocketResponseBody>()
+
+    /**
+     * The number of active HTTP transfers sharing the engine-wide speed limits,
+     * and the number they were last split between. Accessed on the curl thread only.
+     */
+    private var speedLimitedTransfers = 0
+    private var balancedTransfers = 0
+
+    private val heartbeat = webSocketPingIntervalMillis?.let { interval ->
+        CurlWebSocketHeartbeat(
+            interval,
+            webSocketPingTimeoutMillis,
+            isActive = { activeHandles[it.easyHandle]?.responseWrapper?.get() === it },
+            isReceivePaused = { (activeHandles[it.easyHandle]?.pausedDirections ?: 0) and CURLPAUSE_RECV != 0 },
+            onTimeout = ::onWebSocketPingTimeout,
+        )
+    }
 
     override fun close() {
         if (activeHandles.isNotEmpty() || cancelledHandles.isNotEmpty()) handleCompleted()
@@ -56,60 +139,137 @@ internal class CurlMultiApiHandler : Closeable {
         curl_multi_cleanup(multiHandle).verify()
     }
 
-    fun scheduleRequest(request: CurlRequestData, deferred: CompletableDeferred<CurlSuccess>): EasyHandle {
+    fun scheduleRequest(request: CurlRequestData, deferred: CompletableDeferred<CurlSuccess>): EasyHandle =
+        scheduleTransfer(request, deferred, resumed = null)
+
+    private fun scheduleTransfer(
+        request: CurlRequestData,
+        deferred: CompletableDeferred<CurlSuccess>,
+        resumed: ResumedTransfer?,
+    ): EasyHandle {
+        val requestHeaders = resumed?.headers ?: request.headers
         val easyHandle = curl_easy_init()
             ?: run {
-                curl_slist_free_all(request.headers)
+                curl_slist_free_all(requestHeaders)
                 error("Could not initialize an easy handle")
             }
 
         val bodyStartedReceiving = CompletableDeferred<Unit>()
-        val responseBody = if (request.isUpgradeRequest) {
-            val wsConfig = request.attributes[WEBSOCKETS_KEY]
-            CurlWebSocketResponseBody(
+        val responseBody = when {
+            resumed != null -> resumed.body.apply {
+                onPause = { pauseEasyHandle(easyHandle, CURLPAUSE_RECV) }
+                onUnpause = { unpauseEasyHandle(easyHandle, CURLPAUSE_RECV) }
+            }
+
+            request.isUpgradeRequest -> {
+                val wsConfig = request.attributes[WEBSOCKETS_KEY]
+                CurlWebSocketResponseBody(
+                    easyHandle,
+                    request.callContext,
+                    wsConfig.channelsConfig.incoming,
+                    wsConfig.maxFrameSize,
+                    onPause = { pauseEasyHandle(easyHandle, CURLPAUSE_RECV) },
+                    onUnpause = { unpauseEasyHandle(easyHandle, CURLPAUSE_RECV) },
+                    onFramesQueued = ::scheduleWebSocketSend,
+                    isRawMode = request.isRawWebSocket,
+                    streamMessages = request.streamWebSocketMessages,
+                )
+            }
+
+            request.downloadPath != null -> CurlFileResponseBody(
                 easyHandle,
-                wsConfig.channelsConfig.incoming,
-                wsConfig.maxFrameSize,
+                request.downloadPath,
+                request.downloadOffset,
+                errorBody = CurlHttpResponseBody(
+                    request.callContext,
+                    onPause = { pauseEasyHandle(easyHandle, CURLPAUSE_RECV) },
+                    onUnpause = { unpauseEasyHandle(easyHandle, CURLPAUSE_RECV) },
+                ),
+            )
+
+            else -> CurlHttpResponseBody(
+                request.callContext,
+                onPause = { pauseEasyHandle(easyHandle, CURLPAUSE_RECV) },
+                onUnpause = { unpauseEasyHandle(easyHandle, CURLPAUSE_RECV) },
             )
-        } else {
-            CurlHttpResponseBody(request.callContext) {
-                unpauseEasyHandle(easyHandle)
-            }
         }
         val responseData = CurlResponseBuilder(request, bodyStartedReceiving, responseBody)
         val responseDataRef = responseData.toStableRef()
         val responseWrapper = responseBody.toStableRef()
-        val requestWrapper = CurlRequestBodyData(
-            body = request.content,
-            callContext = request.callContext,
-            onUnpause = { unpauseEasyHandle(easyHandle) },
-        ).toStableRef()
+        // A WebSocket handshake has no body, so a session doesn't keep a reader for it
+        val requestWrapper = if (request.isUpgradeRequest) {
+            null
+        } else {
+            CurlRequestBodyData(
+                body = request.content,
+                callContext = request.callContext,
+                onPause = { pauseEasyHandle(easyHandle, CURLPAUSE_SEND) },
+                onUnpause = { unpauseEasyHandle(easyHandle, CURLPAUSE_SEND) },
+                streamedBody = request.streamedContent,
+            ).toStableRef()
+        }
+        val inMemoryContent = request.inMemoryContent
+            ?.takeIf { it.isNotEmpty() && sendsContentAsPostFields(request.method) }
+            ?.pin()
         val requestHolder = RequestHolder(
             deferred,
-            request.headers,
+            requestHeaders,
             responseDataRef,
             requestWrapper,
             responseWrapper,
+            inMemoryContent,
+            resumeAttempt = resumed?.attempt ?: 0,
         )
 
         bodyStartedReceiving.invokeOnCompletion {
             val result = collectSuccessResponse(easyHandle) ?: return@invokeOnCompletion
+            if (result.status == HttpStatusCode.SwitchingProtocols.value && responseBody is CurlWebSocketResponseBody) {
+                heartbeat?.add(responseBody)
+            }
             activeHandles[easyHandle]!!.responseCompletable.complete(result)
         }
 
         try {
             setupMethod(easyHandle, request.method, request.contentLength)
-            setupUploadContent(easyHandle, requestWrapper.asCPointer())
+            val uploadFilePath = request.uploadFilePath
+            val mimeParts = request.mimeParts
+            when {
+                mimeParts != null -> setupMimeContent(easyHandle, mimeParts, requestHolder)
+
+                inMemoryContent != null -> setupInMemoryContent(easyHandle, inMemoryContent)
+
+                uploadFilePath != null -> {
+                    val file = fopen(uploadFilePath, "rb") ?: throw IOException("Failed to open $uploadFilePath")
+                    requestHolder.uploadFile = file
+                    setupFileContent(easyHandle, file)
+                }
+
+                requestWrapper != null -> {
+                    setupUploadContent(easyHandle, requestWrapper.asCPointer(), request.sendsTrailers)
+                }
+            }
 
             easyHandle.apply {
                 option(CURLOPT_URL, request.url)
-                option(CURLOPT_HTTPHEADER, request.headers)
+                option(CURLOPT_HTTPHEADER, requestHeaders)
                 option(CURLOPT_HEADERFUNCTION, staticCFunction(::onHeadersReceived))
                 option(CURLOPT_HEADERDATA, responseDataRef.asCPointer())
                 option(CURLOPT_WRITEFUNCTION, staticCFunction(::onBodyChunkReceived))
                 option(CURLOPT_WRITEDATA, responseWrapper.asCPointer())
                 option(CURLOPT_PRIVATE, responseDataRef.asCPointer())
-                option(CURLOPT_ACCEPT_ENCODING, "")
+                when {
+                    request.passThroughContentEncoding -> option(CURLOPT_HTTP_CONTENT_DECODING, 0L)
+
+                    // A decoded body can't be continued from a byte offset
+                    request.maxResumeAttempts > 0 -> {}
+
+                    request.offloadContentDecoding -> {
+                        option(CURLOPT_ACCEPT_ENCODING, "gzip, deflate")
+                        option(CURLOPT_HTTP_CONTENT_DECODING, 0L)
+                    }
+
+                    else -> option(CURLOPT_ACCEPT_ENCODING, "")
+                }
                 request.connectTimeout?.let {
                     if (it != HttpTimeoutConfig.INFINITE_TIMEOUT_MS) {
                         option(CURLOPT_CONNECTTIMEOUT_MS, request.connectTimeout)
@@ -117,6 +277,18 @@ internal class CurlMultiApiHandler : Closeable {
                         option(CURLOPT_CONNECTTIMEOUT_MS, Long.MAX_VALUE)
                     }
                 }
+                request.requestTimeout?.let {
+                    if (it != HttpTimeoutConfig.INFINITE_TIMEOUT_MS) {
+                        option(CURLOPT_TIMEOUT_MS, it)
+                    }
+                }
+                request.socketTimeout?.let {
+                    if (it != HttpTimeoutConfig.INFINITE_TIMEOUT_MS) {
+                        // libcurl detects stalled transfers with a granularity of whole seconds
+                        option(CURLOPT_LOW_SPEED_LIMIT, 1L)
+                        option(CURLOPT_LOW_SPEED_TIME, (it + 999) / 1000)
+                    }
+                }
 
                 request.proxy?.let { proxy ->
                     option(CURLOPT_PROXY, fixProxyUrl(proxy.toString(), proxy.type))
@@ -132,6 +304,51 @@ internal class CurlMultiApiHandler : Closeable {
                 }
                 request.caPath?.let { option(CURLOPT_CAPATH, it) }
                 request.caInfo?.let { option(CURLOPT_CAINFO, it) }
+
+                val transfersShare = if (request.isUpgradeRequest) 1 else speedLimitedTransfers + 1
+                setupSpeedLimits(easyHandle, requestHolder, transfersShare)
+
+                if (request.downloadPath != null) {
+                    option(CURLOPT_BUFFERSIZE, FILE_TRANSFER_BUFFER_SIZE)
+                }
+
+                if (request.isUpgradeRequest) {
+                    var wsOptions = 0L
+                    // The frames are encoded and decoded by ktor, so extensions can use the RSV bits
+                    if (request.isRawWebSocket) wsOptions = wsOptions or Libcurl.WS_RAW_MODE
+                    if (!webSocketAutoPong) wsOptions = wsOptions or Libcurl.WS_NOAUTOPONG
+                    if (wsOptions != 0L) option(CURLOPT_WS_OPTIONS, wsOptions)
+                }
+
+                if (request.isDuplex) {
+                    // Only HTTP/2 sends the request body while the response is received on the same stream
+                    val httpVersion = if (request.protocol == URLProtocol.HTTPS.name) {
+                        CURL_HTTP_VERSION_2TLS
+                    } else {
+                        CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE
+                    }
+                    option(CURLOPT_HTTP_VERSION, httpVersion.toLong())
+                }
+
+                if (request.sendsTrailers) {
+                    // libcurl sends request trailers only after a chunked HTTP/1.1 body, never over HTTP/2
+                    option(CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1.toLong())
+                }
+
+                request.unixSocketPath?.let { path ->
+                    val socketOption = if (request.abstractUnixSocket) {
+                        CURLOPT_ABSTRACT_UNIX_SOCKET
+                    } else {
+                        CURLOPT_UNIX_SOCKET_PATH
+                    }
+                    option(socketOption, path)
+                }
+
+                resumed?.let {
+                    option(CURLOPT_RESUME_FROM_LARGE, it.offset)
+                    // Any response but the requested range is an error and must not reach the body channel
+                    option(CURLOPT_FAILONERROR, 1L)
+                }
             }
 
             curl_multi_add_handle(multiHandle, easyHandle).verify()
@@ -150,9 +367,55 @@ internal class CurlMultiApiHandler : Closeable {
         }
 
         activeHandles[easyHandle] = requestHolder
+        // The other transfers get their smaller share once all the handles added together are set up
+        if (!request.isUpgradeRequest) speedLimitedTransfers++
         return easyHandle
     }
 
+    private fun setupSpeedLimits(easyHandle: EasyHandle, holder: RequestHolder, transfersShare: Int) {
+        val request = holder.request
+        // 0 disables the limit
+        val sendSpeed = minSpeed(request.maxSendSpeed, maxTotalSendSpeed?.div(transfersShare)) ?: 0L
+        val receiveSpeed = minSpeed(request.maxReceiveSpeed, maxTotalReceiveSpeed?.div(transfersShare)) ?: 0L
+
+        if (sendSpeed != holder.sendSpeedLimit) {
+            easyHandle.option(CURLOPT_MAX_SEND_SPEED_LARGE, sendSpeed)
+            holder.sendSpeedLimit = sendSpeed
+        }
+        if (receiveSpeed != holder.receiveSpeedLimit) {
+            easyHandle.option(CURLOPT_MAX_RECV_SPEED_LARGE, receiveSpeed)
+            holder.receiveSpeedLimit = receiveSpeed
+        }
+    }
+
+    /**
+     * Splits the engine-wide bandwidth budget evenly between the active HTTP transfers
+     * if their number has changed since the last split.
+     * libcurl applies the updated limits to transfers that are already in progress.
+     */
+    private fun rebalanceSpeedLimits() {
+        if (maxTotalSendSpeed == null && maxTotalReceiveSpeed == null) return
+        if (speedLimitedTransfers == balancedTransfers) return
+
+        balancedTransfers = speedLimitedTransfers
+        for ((easyHandle, holder) in activeHandles) {
+            if (holder.request.isUpgradeRequest) continue
+            setupSpeedLimits(easyHandle, holder, speedLimitedTransfers)
+        }
+    }
+
+    private fun removeActiveHandle(easyHandle: EasyHandle): RequestHolder? {
+        val holder = activeHandles.remove(easyHandle) ?: return null
+        if (!holder.request.isUpgradeRequest) speedLimitedTransfers--
+        return holder
+    }
+
+    private fun minSpeed(first: Long?, second: Long?): Long? = when {
+        first == null -> second?.coerceAtLeast(1)
+        second == null -> first
+        else -> minOf(first, second.coerceAtLeast(1))
+    }
+
     private fun fixProxyUrl(url: String, proxyType: ProxyType): String {
         return if (proxyType == ProxyType.SOCKS) url.replaceFirst("socks://", "socks5h://") else url
     }
@@ -179,15 +442,29 @@ internal class CurlMultiApiHandler : Closeable {
         if (activeHandles.isEmpty()) return
 
         synchronized(easyHandlesToUnpauseLock) {
-            var handle = easyHandlesToUnpause.removeFirstOrNull()
-            while (handle != null) {
-                if (handle in activeHandles) curl_easy_pause(handle, CURLPAUSE_CONT)
-                handle = easyHandlesToUnpause.removeFirstOrNull()
+            var unpause = easyHandlesToUnpause.removeFirstOrNull()
+            while (unpause != null) {
+                val (handle, direction) = unpause
+                activeHandles[handle]?.let { holder ->
+                    // The other direction stays paused, so a slow reader doesn't hold back the upload and vice versa
+                    holder.pausedDirections = holder.pausedDirections and direction.inv()
+                    curl_easy_pause(handle, holder.pausedDirections)
+                }
+                unpause = easyHandlesToUnpause.removeFirstOrNull()
             }
         }
+        rebalanceSpeedLimits()
+        // Pings are queued before sending, so they go out in this iteration
+        heartbeat?.advance()
+        sendWebSocketFrames()
         curl_multi_perform(multiHandle, transfersRunning.ptr).verify()
         if (transfersRunning.value != 0) {
-            curl_multi_poll(multiHandle, null, 0.toUInt(), pollTimeout, null).verify()
+            // libcurl doesn't wait for a WebSocket connection to become writable, so blocked sends are retried sooner
+            var timeout = if (sendingWebSockets.isEmpty()) pollTimeout else WEBSOCKET_SEND_RETRY_TIMEOUT_MS
+            if (heartbeat != null && !heartbeat.isEmpty()) {
+                timeout = minOf(timeout, heartbeat.millisUntilNextTick())
+            }
+            curl_multi_poll(multiHandle, null, 0.toUInt(), timeout, null).verify()
         }
         if (transfersRunning.value < activeHandles.size) {
             handleCompleted()
@@ -228,10 +505,89 @@ internal class CurlMultiApiHandler : Closeable {
         }
     }
 
-    private fun setupUploadContent(easyHandle: EasyHandle, requestPointer: COpaquePointer) {
+    /**
+     * Hands the pinned body to libcurl directly, skipping the read callback and the intermediate channel.
+     * The array stays pinned until the request holder is disposed.
+     */
+    private fun setupInMemoryContent(easyHandle: EasyHandle, content: Pinned<ByteArray>) {
+        easyHandle.apply {
+            option(CURLOPT_POSTFIELDSIZE_LARGE, content.get().size.toLong())
+            option(CURLOPT_POSTFIELDS, content.addressOf(0))
+        }
+    }
+
+    /**
+     * Lets libcurl read the body from the [file] with its default `fread` callback right on the curl thread.
+     * libcurl also rewinds such a file with `fseek` by itself when the body needs to be resent.
+     */
+    private fun setupFileContent(easyHandle: EasyHandle, file: CPointer<FILE>) {
+        easyHandle.apply {
+            option(CURLOPT_READDATA, file)
+            option(CURLOPT_UPLOAD_BUFFERSIZE, FILE_TRANSFER_BUFFER_SIZE)
+        }
+    }
+
+    /**
+     * Lets libcurl build a `multipart/form-data` body, so file parts are read from disk on the curl thread
+     * and other parts are read from their channels without serializing the whole body in Kotlin.
+     * The mime structure and the part readers live until the request holder is disposed.
+     */
+    private fun setupMimeContent(easyHandle: EasyHandle, parts: List<CurlMimePart>, holder: RequestHolder) {
+        val mime = curl_mime_init(easyHandle) ?: error("Could not initialize a mime structure")
+        holder.mime = mime
+
+        for (part in parts) {
+            val mimePart = curl_mime_addpart(mime) ?: error("Could not add a mime part")
+            var headers: CPointer<curl_slist>? = null
+            for (header in part.headers) {
+                headers = curl_slist_append(headers, header)
+            }
+            curl_mime_headers(mimePart, headers, 1).verify()
+
+            when (part) {
+                is CurlMimePart.Data -> {
+                    curl_mime_data(mimePart, part.value, part.value.encodeToByteArray().size.convert()).verify()
+                }
+
+                is CurlMimePart.File -> {
+                    if (curl_mime_filedata(mimePart, part.path) != CURLE_OK) {
+                        throw IOException("Failed to open ${part.path}")
+                    }
+                    // The file name is already in the Content-Disposition header of the part
+                    curl_mime_filename(mimePart, null).verify()
+                }
+
+                is CurlMimePart.Stream -> {
+                    val reader = CurlRequestBodyData(
+                        body = part.channel,
+                        callContext = holder.request.callContext,
+                        onPause = { pauseEasyHandle(easyHandle, CURLPAUSE_SEND) },
+                        onUnpause = { unpauseEasyHandle(easyHandle, CURLPAUSE_SEND) },
+                    ).toStableRef()
+                    holder.mimeStreams += reader
+                    curl_mime_data_cb(
+                        mimePart,
+                        part.size,
+                        staticCFunction(::onBodyChunkRequested).reinterpret(),
+                        null,
+                        null,
+                        reader.asCPointer(),
+                    ).verify()
+                }
+            }
+        }
+
+        easyHandle.option(CURLOPT_MIMEPOST, mime)
+    }
+
+    private fun setupUploadContent(easyHandle: EasyHandle, requestPointer: COpaquePointer, withTrailers: Boolean) {
         easyHandle.apply {
             option(CURLOPT_READDATA, requestPointer)
             option(CURLOPT_READFUNCTION, staticCFunction(::onBodyChunkRequested))
+            if (withTrailers) {
+                option(CURLOPT_TRAILERDATA, requestPointer)
+                option(CURLOPT_TRAILERFUNCTION, staticCFunction(::onTrailersRequested))
+            }
         }
     }
 
@@ -262,14 +618,14 @@ internal class CurlMultiApiHandler : Closeable {
                         is CurlFail -> deferred.completeExceptionally(result.cause)
                     }
                 } finally {
-                    activeHandles.remove(easyHandle)!!.dispose()
+                    removeActiveHandle(easyHandle)!!.dispose()
                 }
             } while (messagesLeft.value != 0)
         }
     }
 
     private fun removeEasyHandle(easyHandle: EasyHandle, cause: Throwable) {
-        val handler = activeHandles.remove(easyHandle) ?: return
+        val handler = removeActiveHandle(easyHandle) ?: return
         try {
             processCancelledEasyHandle(easyHandle, cause)
         } finally {
@@ -303,24 +659,44 @@ internal class CurlMultiApiHandler : Closeable {
             val responseDataRef = alloc<COpaquePointerVar>()
             val httpStatusCode = alloc<LongVar>()
             val proxyCode = alloc<CURLproxycode.Var>()
+            val totalTime = alloc<curl_off_tVar>()
+            val preTransferTime = alloc<curl_off_tVar>()
 
             easyHandle.apply {
                 getInfo(CURLINFO_RESPONSE_CODE, httpStatusCode.ptr)
                 getInfo(CURLINFO_PRIVATE, responseDataRef.ptr)
                 getInfo(CURLINFO_PROXY_ERROR, proxyCode.ptr)
+                getInfo(CURLINFO_TOTAL_TIME_T, totalTime.ptr)
+                getInfo(CURLINFO_PRETRANSFER_TIME_T, preTransferTime.ptr)
             }
 
             val responseBuilder = responseDataRef.value!!.fromCPointer<CurlResponseBuilder>()
+            var failure: Throwable? = null
             try {
-                collectFailedResponse(
+                val response = collectFailedResponse(
                     message = message,
                     request = responseBuilder.request,
                     result = result,
                     httpStatusCode = httpStatusCode.value,
-                    proxyCode = proxyCode.value
+                    proxyCode = proxyCode.value,
+                    totalTimeMicros = totalTime.value,
+                    connected = preTransferTime.value > 0,
+                    bodyStarted = responseBuilder.bodyStartedReceiving.isCompleted ||
+                        (activeHandles[easyHandle]?.resumeAttempt ?: 0) > 0,
                 ) ?: collectSuccessResponse(easyHandle)!!
+                failure = (response as? CurlFail)?.cause
+                response
             } finally {
-                responseBuilder.responseBody.close()
+                val resumed = failure != null &&
+                    resumeTransfer(easyHandle, responseBuilder, result, httpStatusCode.value)
+                if (failure == null) {
+                    // Trailers follow the body, so they can only be read once the transfer is complete
+                    (responseBuilder.responseBody as? CurlHttpResponseBody)?.trailers?.complete(
+                        easyHandle.responseTrailers()
+                    )
+                }
+                // A timeout may happen after the headers are received, so it has to reach the body reader
+                if (!resumed) responseBuilder.responseBody.close(failure)
                 responseBuilder.headersBytes.close()
             }
         } finally {
@@ -328,12 +704,54 @@ internal class CurlMultiApiHandler : Closeable {
         }
     }
 
+    /**
+     * Continues the body of a response interrupted by a connection failure in a new transfer.
+     * Returns `false` if the body can't be continued, so the failure has to reach the body reader.
+     */
+    private fun resumeTransfer(
+        easyHandle: EasyHandle,
+        responseBuilder: CurlResponseBuilder,
+        result: CURLcode,
+        httpStatusCode: Long,
+    ): Boolean {
+        val holder = activeHandles[easyHandle] ?: return false
+        val request = responseBuilder.request
+        val body = responseBuilder.responseBody as? CurlHttpResponseBody ?: return false
+        if (result !in INTERRUPTED_BODY_ERRORS || holder.resumeAttempt >= request.maxResumeAttempts) return false
+        if (!responseBuilder.bodyStartedReceiving.isCompleted || body.bodyChannel.isClosedForWrite) return false
+
+        val headers = if (holder.resumeAttempt == 0) {
+            if (httpStatusCode != HttpStatusCode.OK.value.toLong()) return false
+            val contentEncoding = easyHandle.responseHeader(HttpHeaders.ContentEncoding)
+            if (contentEncoding != null && !contentEncoding.equals("identity", ignoreCase = true)) return false
+
+            val validator = easyHandle.responseHeader(HttpHeaders.ETag)?.takeUnless { it.startsWith("W/") }
+                ?: easyHandle.responseHeader(HttpHeaders.LastModified)
+                ?: return false
+            holder.requestHeaders.copyWith("${HttpHeaders.IfRange}: $validator")
+        } else {
+            // If-Range is already there
+            holder.requestHeaders.copyWith()
+        }
+
+        val resumed = ResumedTransfer(body, body.bytesReceived, headers, attempt = holder.resumeAttempt + 1)
+        return try {
+            scheduleTransfer(request, CompletableDeferred(), resumed)
+            true
+        } catch (_: Throwable) {
+            false
+        }
+    }
+
     private fun collectFailedResponse(
         message: CURLMSG?,
         request: CurlRequestData,
         result: CURLcode,
         httpStatusCode: Long,
         proxyCode: CURLproxycode,
+        totalTimeMicros: Long,
+        connected: Boolean,
+        bodyStarted: Boolean,
     ): CurlFail? {
         if (message != CURLMSG.CURLMSG_DONE) {
             return CurlFail(
@@ -341,16 +759,31 @@ internal class CurlMultiApiHandler : Closeable {
             )
         }
 
-        if (httpStatusCode != 0L) {
-            return null
-        }
-
         if (result == CURLE_OPERATION_TIMEDOUT) {
-            return CurlFail(ConnectTimeoutException(request.url, request.connectTimeout))
+            return CurlFail(collectTimeoutCause(request, totalTimeMicros, connected))
         }
 
         val errorMessage = result.errorMessage
 
+        if (httpStatusCode != 0L && result in INTERRUPTED_BODY_ERRORS) {
+            return CurlFail(
+                IllegalStateException("Response body was interrupted for request: $request. Reason: $errorMessage")
+            )
+        }
+
+        // Once a body has started, or is being continued, any error leaves it incomplete.
+        // For example, a resumed transfer fails with CURLE_RANGE_ERROR or CURLE_HTTP_RETURNED_ERROR
+        // when the resource has changed, so the rest of the body never arrives.
+        if (httpStatusCode != 0L && result != CURLE_OK && bodyStarted && !request.isUpgradeRequest) {
+            return CurlFail(
+                IllegalStateException("Response body is incomplete for request: $request. Reason: $errorMessage")
+            )
+        }
+
+        if (httpStatusCode != 0L) {
+            return null
+        }
+
         if (result == CURLE_PEER_FAILED_VERIFICATION) {
             return CurlFail(
                 IllegalStateException(
@@ -370,6 +803,39 @@ internal class CurlMultiApiHandler : Closeable {
         )
     }
 
+    /**
+     * libcurl reports every expired timeout as `CURLE_OPERATION_TIMEDOUT`,
+     * so the kind of timeout is derived from the phase the transfer reached and how long it took.
+     * [connected] tells whether the connection (including the TLS handshake) was established.
+     */
+    private fun collectTimeoutCause(
+        request: CurlRequestData,
+        totalTimeMicros: Long,
+        connected: Boolean,
+    ): Throwable {
+        val connectTimeout = request.connectTimeout ?: DEFAULT_CONNECT_TIMEOUT_MS
+        if (!connected && connectTimeout.hasExpired(totalTimeMicros)) {
+            return ConnectTimeoutException(request.url, request.connectTimeout)
+        }
+
+        val requestTimeout = request.requestTimeout
+        if (requestTimeout != null && requestTimeout.hasExpired(totalTimeMicros)) {
+            return HttpRequestTimeoutException(request.url, requestTimeout)
+        }
+
+        // Neither timeout has elapsed, so the transfer stalled before the connection was established
+        if (!connected) {
+            return ConnectTimeoutException(request.url, request.connectTimeout)
+        }
+
+        return SocketTimeoutException(
+            "Socket timeout has expired [url=${request.url}, socket_timeout=${request.socketTimeout ?: "unknown"}] ms"
+        )
+    }
+
+    private fun Long.hasExpired(totalTimeMicros: Long): Boolean =
+        this != HttpTimeoutConfig.INFINITE_TIMEOUT_MS && totalTimeMicros >= this * 1000
+
     private fun collectSuccessResponse(easyHandle: EasyHandle): CurlSuccess? = memScoped {
         val responseDataRef = alloc<COpaquePointerVar>()
         val httpProtocolVersion = alloc<LongVar>()
@@ -403,57 +869,109 @@ internal class CurlMultiApiHandler : Closeable {
         curl_multi_wakeup(multiHandle)
     }
 
-    fun sendWebSocketFrame(
-        websocket: CurlWebSocketResponseBody,
-        flags: Int,
-        data: ByteArray,
-        completionHandler: CompletableJob
-    ) {
-        try {
-            trySendWebSocketFrame(websocket.easyHandle, flags, data)
-            completionHandler.complete()
-        } catch (cause: Throwable) {
-            completionHandler.completeExceptionally(cause)
+    private fun scheduleWebSocketSend(websocket: CurlWebSocketResponseBody) {
+        synchronized(webSocketsToSendLock) {
+            webSocketsToSend.add(websocket)
         }
+        curl_multi_wakeup(multiHandle)
     }
 
-    private fun trySendWebSocketFrame(
-        easyHandle: EasyHandle,
-        flags: Int,
-        data: ByteArray,
-    ) = memScoped {
-        var offset = 0
+    /**
+     * Sends the queued frames of all WebSockets. A WebSocket whose frames are not taken completely
+     * because its connection is not writable is sent to again on the next iteration of the loop.
+     */
+    private fun sendWebSocketFrames() {
+        synchronized(webSocketsToSendLock) {
+            sendingWebSockets.addAll(webSocketsToSend)
+            webSocketsToSend.clear()
+        }
+        if (sendingWebSockets.isEmpty()) return
+
+        val iterator = sendingWebSockets.iterator()
+        while (iterator.hasNext()) {
+            val websocket = iterator.next()
+            val easyHandle = websocket.easyHandle
+            val holder = activeHandles[easyHandle]
+            if (holder == null || holder.responseWrapper.get() !== websocket) {
+                iterator.remove()
+                continue
+            }
+
+            try {
+                if (trySendWebSocketFrames(websocket)) iterator.remove()
+            } catch (cause: Throwable) {
+                iterator.remove()
+                removeEasyHandle(easyHandle, cause)
+            }
+        }
+    }
+
+    /**
+     * Sends the queued frames until the queue is drained or libcurl returns `CURLE_AGAIN`.
+     * Returns `false` in the latter case, the partially sent frame is continued from its offset.
+     */
+    private fun trySendWebSocketFrames(websocket: CurlWebSocketResponseBody): Boolean = memScoped {
         val sent = alloc<size_tVar>()
-        data.usePinned { pinned ->
-            while (true) {
-                val bufferStart = if (data.isNotEmpty()) pinned.addressOf(offset) else null
-                val remaining = if (data.isNotEmpty()) data.size - offset else 0
-
-                val status = curl_ws_send(
-                    curl = easyHandle,
-                    buffer_arg = bufferStart,
-                    buflen = remaining.convert(),
+        val queue = websocket.sendQueue
+        while (true) {
+            val frame = queue.peek() ?: break
+            val frameLength = frame.frameLength
+            if (frameLength != null) {
+                // Only the header of a streamed frame, its payload is sent by the following entries
+                val status = curl_ws_start_frame(websocket.easyHandle, frame.flags.convert(), frameLength)
+                if (status == CURLE_AGAIN) return false
+                status.verify()
+                queue.remove(frame)
+                continue
+            }
+
+            val status = frame.data.usePinned { pinned ->
+                curl_ws_send(
+                    curl = websocket.easyHandle,
+                    buffer_arg = if (frame.size > 0) pinned.addressOf(frame.offset) else null,
+                    buflen = (frame.size - frame.offset).convert(),
                     sent = sent.ptr,
                     fragsize = 0,
-                    flags = flags.convert(),
+                    flags = frame.flags.convert(),
                 )
+            }
 
-                when (status) {
-                    CURLE_OK -> {
-                        offset += sent.value.toInt()
-                        if (data.isEmpty() || offset == data.size) break
-                    }
+            when (status) {
+                CURLE_OK -> {
+                    frame.offset += sent.value.toInt()
+                    if (frame.offset == frame.size) queue.remove(frame)
+                }
 
-                    // TODO: Handle CURLE_AGAIN
-                    else -> status.verify()
+                CURLE_AGAIN -> {
+                    frame.offset += sent.value.toInt()
+                    return false
                 }
+
+                else -> status.verify()
             }
         }
+        true
     }
 
-    private fun unpauseEasyHandle(easyHandle: EasyHandle) {
+    private fun onWebSocketPingTimeout(websocket: CurlWebSocketResponseBody) {
+        val request = activeHandles[websocket.easyHandle]?.request ?: return
+        val cause = SocketTimeoutException(
+            "WebSocket ping timeout has expired [url=${request.url}, ping_timeout=$webSocketPingTimeoutMillis ms]"
+        )
+        removeEasyHandle(websocket.easyHandle, cause)
+    }
+
+    /**
+     * Records a [direction] paused by a callback of the [easyHandle]. Called on the curl thread.
+     */
+    private fun pauseEasyHandle(easyHandle: EasyHandle, direction: Int) {
+        val holder = activeHandles[easyHandle] ?: return
+        holder.pausedDirections = holder.pausedDirections or direction
+    }
+
+    private fun unpauseEasyHandle(easyHandle: EasyHandle, direction: Int) {
         synchronized(easyHandlesToUnpauseLock) {
-            easyHandlesToUnpause.add(easyHandle)
+            easyHandlesToUnpause.add(easyHandle to direction)
         }
         curl_multi_wakeup(multiHandle)
     }
@@ -465,6 +983,10 @@ internal class CurlMultiApiHandler : Closeable {
 
     private companion object {
         private const val DEFAULT_POLL_TIMEOUT_MS = 100
+        private const val WEBSOCKET_SEND_RETRY_TIMEOUT_MS = 5
+
+        // libcurl's own connect timeout, used when the request doesn't set one
+        private const val DEFAULT_CONNECT_TIMEOUT_MS = 300_000L
         val pollTimeout by lazy { getenv("KTOR_CURL_POLL_TIMEOUT")?.toKString()?.toInt() ?: DEFAULT_POLL_TIMEOUT_MS }
     }
 }
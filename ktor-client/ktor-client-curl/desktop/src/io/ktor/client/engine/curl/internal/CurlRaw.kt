@@ -17,9 +17,11 @@ import io.ktor.utils.io.core.*
 import kotlinx.cinterop.CPointer
 import kotlinx.cinterop.ExperimentalForeignApi
 import kotlinx.coroutines.CompletableDeferred
+import kotlinx.coroutines.CoroutineStart
 import kotlinx.coroutines.DelicateCoroutinesApi
 import kotlinx.coroutines.GlobalScope
 import kotlinx.coroutines.Job
+import kotlinx.coroutines.launch
 import libcurl.curl_slist
 import kotlin.coroutines.coroutineContext
 
@@ -27,23 +29,89 @@ import kotlin.coroutines.coroutineContext
 internal suspend fun HttpRequestData.toCurlRequest(
     config: CurlClientEngineConfig,
     callContext: Job,
-): CurlRequestData = CurlRequestData(
-    protocol = url.protocol.name,
-    url = url.toString(),
-    method = method.value,
-    headers = headersToCurl(),
-    proxy = config.proxy,
-    content = body.toByteChannel(),
-    contentLength = body.contentLength ?: headers[HttpHeaders.ContentLength]?.toLongOrNull() ?: -1L,
-    connectTimeout = getCapabilityOrNull(HttpTimeoutCapability)?.connectTimeoutMillis,
-    callContext = callContext,
-    isUpgradeRequest = isUpgradeRequest(),
-    forceProxyTunneling = config.forceProxyTunneling,
-    sslVerify = config.sslVerify,
-    caInfo = config.caInfo,
-    caPath = config.caPath,
-    attributes = attributes,
-)
+): CurlRequestData {
+    val timeout = getCapabilityOrNull(HttpTimeoutCapability)
+    val curlConfig = getCapabilityOrNull(CurlRequestCapability)
+    val isDuplex = curlConfig?.duplexStreaming == true && !isUpgradeRequest() && body.isStreamed()
+    check(!isDuplex || config.duplexStreamingEnabled) {
+        "Duplex streaming of $url requires duplexStreamingEnabled in the Curl engine config"
+    }
+    // Long-lived upgrade and SSE connections are not limited by the request timeout, same as in HttpTimeout
+    val isStreamingRequest = isUpgradeRequest() || isSseRequest()
+    val mimeParts = if (sendsContentAsPostFields(method.value)) body.toCurlMimeParts() else null
+    val inMemoryBody = body.inMemoryBytes()
+    val uploadFilePath = body.localFilePath()
+    val requestTrailers = curlConfig?.requestTrailers
+    check(requestTrailers == null || !isDuplex) {
+        "Trailers of $url can't be sent with duplex streaming: libcurl sends them only over HTTP/1.1"
+    }
+    val streamedContent = if (mimeParts == null) body.startWriting(requestTrailers) else null
+    check(requestTrailers == null || streamedContent != null) {
+        "Trailers of $url can only be sent after a WriteChannelContent body"
+    }
+    val downloadPath = curlConfig?.downloadPath?.toString()
+    val streamWebSocketMessages = isUpgradeRequest() && curlConfig?.streamWebSocketMessages == true
+
+    return CurlRequestData(
+        protocol = url.protocol.name,
+        url = url.toString(),
+        method = method.value,
+        // libcurl generates the multipart headers with its own boundary
+        headers = headersToCurl(
+            skipContentHeaders = mimeParts != null,
+            // Extensions process whole frames, which streamed messages are never assembled into
+            skipWebSocketExtensions = streamWebSocketMessages,
+        ),
+        proxy = config.proxy,
+        content = when {
+            mimeParts != null -> ByteReadChannel.Empty
+            inMemoryBody != null -> ByteReadChannel(inMemoryBody)
+            uploadFilePath != null -> ByteReadChannel.Empty
+            streamedContent != null -> ByteReadChannel.Empty
+            else -> body.toByteChannel()
+        },
+        inMemoryContent = inMemoryBody,
+        uploadFilePath = uploadFilePath,
+        mimeParts = mimeParts,
+        streamedContent = streamedContent,
+        contentLength = when {
+            mimeParts != null -> -1L
+            else -> body.contentLength ?: headers[HttpHeaders.ContentLength]?.toLongOrNull() ?: -1L
+        },
+        connectTimeout = timeout?.connectTimeoutMillis,
+        requestTimeout = timeout?.requestTimeoutMillis?.takeUnless { isStreamingRequest },
+        socketTimeout = timeout?.socketTimeoutMillis?.takeUnless { isUpgradeRequest() },
+        callContext = callContext,
+        isUpgradeRequest = isUpgradeRequest(),
+        forceProxyTunneling = config.forceProxyTunneling,
+        sslVerify = config.sslVerify,
+        caInfo = config.caInfo,
+        caPath = config.caPath,
+        unixSocketPath = getCapabilityOrNull(UnixSocketCapability)?.path ?: config.unixSocketPath,
+        abstractUnixSocket = config.abstractUnixSocket,
+        maxSendSpeed = curlConfig?.maxSendSpeed ?: config.maxSendSpeed,
+        maxReceiveSpeed = curlConfig?.maxReceiveSpeed ?: config.maxReceiveSpeed,
+        // A body written to a file never reaches the channel that would be decoded off the curl thread
+        offloadContentDecoding = downloadPath == null &&
+            (curlConfig?.offloadContentDecoding ?: config.offloadContentDecoding),
+        passThroughContentEncoding = curlConfig?.passThroughContentEncoding == true,
+        downloadPath = downloadPath,
+        downloadOffset = curlConfig?.downloadOffset ?: 0L,
+        // Only a complete body streamed to the channel of a GET can be continued with a range request
+        maxResumeAttempts = if (isResumable(downloadPath, isStreamingRequest)) {
+            curlConfig?.maxResumeAttempts ?: config.maxResumeAttempts
+        } else {
+            0
+        },
+        sendsTrailers = requestTrailers != null,
+        isDuplex = isDuplex,
+        // libcurl doesn't pass the RSV bits of frames, which extensions depend on
+        isRawWebSocket = isUpgradeRequest() && headers.contains(HttpHeaders.SecWebSocketExtensions) &&
+            !streamWebSocketMessages,
+        streamWebSocketMessages = streamWebSocketMessages,
+        attributes = attributes,
+    )
+}
 
 internal class CurlRequestData @OptIn(ExperimentalForeignApi::class) constructor(
     val protocol: String,
@@ -52,14 +120,33 @@ internal class CurlRequestData @OptIn(ExperimentalForeignApi::class) constructor
     val headers: CPointer<curl_slist>,
     val proxy: ProxyConfig?,
     val content: ByteReadChannel,
+    val inMemoryContent: ByteArray?,
+    val uploadFilePath: String?,
+    val mimeParts: List<CurlMimePart>?,
+    val streamedContent: CurlRequestBodyChannel?,
     val contentLength: Long,
     val connectTimeout: Long?,
+    val requestTimeout: Long?,
+    val socketTimeout: Long?,
     val callContext: Job,
     val isUpgradeRequest: Boolean,
     val forceProxyTunneling: Boolean,
     val sslVerify: Boolean,
     val caInfo: String?,
     val caPath: String?,
+    val unixSocketPath: String?,
+    val abstractUnixSocket: Boolean,
+    val maxSendSpeed: Long?,
+    val maxReceiveSpeed: Long?,
+    val offloadContentDecoding: Boolean,
+    val passThroughContentEncoding: Boolean,
+    val downloadPath: String?,
+    val downloadOffset: Long,
+    val maxResumeAttempts: Int,
+    val sendsTrailers: Boolean,
+    val isDuplex: Boolean,
+    val isRawWebSocket: Boolean,
+    val streamWebSocketMessages: Boolean,
     val attributes: Attributes
 ) {
     override fun toString(): String =
@@ -91,6 +178,68 @@ internal class CurlFail(
     override fun toString(): String = "CurlFail($cause)"
 }
 
+private fun HttpRequestData.isResumable(downloadPath: String?, isStreamingRequest: Boolean): Boolean =
+    method == HttpMethod.Get && downloadPath == null && !isStreamingRequest && !headers.contains(HttpHeaders.Range)
+
+/**
+ * Returns the body bytes if they are already in memory, so they can be passed to libcurl without a channel.
+ */
+internal fun OutgoingContent.inMemoryBytes(): ByteArray? = when (this) {
+    is OutgoingContent.ByteArrayContent -> bytes()
+    is OutgoingContent.ContentWrapper -> delegate().inMemoryBytes()
+    else -> null
+}
+
+/**
+ * Returns the path of the uploaded file, so libcurl can read it from disk without a channel.
+ */
+internal fun OutgoingContent.localFilePath(): String? = when (this) {
+    is LocalFileContent -> path.toString()
+    is OutgoingContent.ContentWrapper -> delegate().localFilePath()
+    else -> null
+}
+
+/**
+ * Methods sent with `CURLOPT_POST`, so their body can be set with `CURLOPT_POSTFIELDS` or `CURLOPT_MIMEPOST`.
+ */
+internal fun sendsContentAsPostFields(method: String): Boolean =
+    method != "GET" && method != "HEAD" && method != "PUT"
+
+/**
+ * Checks if the body is produced while it is sent, so it can be sent at the same time as the response is received.
+ */
+private fun OutgoingContent.isStreamed(): Boolean = when (this) {
+    is LocalFileContent -> false
+    is OutgoingContent.WriteChannelContent, is OutgoingContent.ReadChannelContent -> true
+    is OutgoingContent.ContentWrapper -> delegate().isStreamed()
+    else -> false
+}
+
+/**
+ * Starts writing a `WriteChannelContent` body to a channel drained by the curl read callback.
+ * The producer runs until its first suspension right away, so a small body is ready before the transfer starts.
+ * The [trailers] are computed by the producer once the body is written, so they can read the state it wrote.
+ */
+@OptIn(DelicateCoroutinesApi::class)
+private suspend fun OutgoingContent.startWriting(trailers: (() -> Headers)?): CurlRequestBodyChannel? = when (this) {
+    is OutgoingContent.WriteChannelContent -> {
+        val channel = CurlRequestBodyChannel()
+        GlobalScope.launch(coroutineContext, start = CoroutineStart.UNDISPATCHED) {
+            try {
+                writeTo(channel)
+                channel.trailers = trailers?.invoke()
+                channel.flushAndClose()
+            } catch (cause: Throwable) {
+                channel.cancel(cause)
+            }
+        }
+        channel
+    }
+
+    is OutgoingContent.ContentWrapper -> delegate().startWriting(trailers)
+    else -> null
+}
+
 @OptIn(DelicateCoroutinesApi::class)
 internal suspend fun OutgoingContent.toByteChannel(): ByteReadChannel = when (this@toByteChannel) {
     is OutgoingContent.ByteArrayContent -> {
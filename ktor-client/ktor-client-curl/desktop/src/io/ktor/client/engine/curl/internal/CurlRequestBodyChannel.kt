@@ -0,0 +1,146 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.internal
+
+import io.ktor.http.*
+import io.ktor.utils.io.*
+import io.ktor.utils.io.core.*
+import io.ktor.utils.io.locks.*
+import kotlinx.cinterop.ByteVar
+import kotlinx.cinterop.CPointer
+import kotlinx.cinterop.ExperimentalForeignApi
+import kotlinx.coroutines.CancellableContinuation
+import kotlinx.coroutines.suspendCancellableCoroutine
+import kotlinx.io.Buffer
+import kotlinx.io.IOException
+import kotlinx.io.Sink
+import kotlin.concurrent.Volatile
+import kotlin.coroutines.resume
+import kotlin.coroutines.resumeWithException
+
+// The same limit as in ByteChannel, so producers flush as often as they would with a regular channel
+private const val MAX_FLUSHED_SIZE = 1024 * 1024L
+
+/**
+ * A request body channel for `WriteChannelContent` drained by the curl read callback.
+ *
+ * Flushed bytes are moved to a buffer that [readTo] copies to libcurl on the curl thread,
+ * so the body doesn't pass through an intermediate [ByteChannel].
+ * The producer suspends in [flush] only while the buffer is full and is resumed by [readTo].
+ * When the buffer is empty, libcurl pauses the upload, and the next [flush] resumes it
+ * without a coroutine waiting for the content.
+ */
+@OptIn(InternalAPI::class, ExperimentalForeignApi::class)
+internal class CurlRequestBodyChannel : ByteWriteChannel {
+    private val lock = SynchronizedObject()
+
+    private val _writeBuffer = Buffer()
+
+    // Guarded by the lock
+    private val flushed = Buffer()
+    private var producer: CancellableContinuation<Unit>? = null
+    private var onReaderUnpause: (() -> Unit)? = null
+
+    @Volatile
+    private var isClosed = false
+
+    @Volatile
+    private var failure: Throwable? = null
+
+    /**
+     * The trailer fields sent after the body. Set by the producer before it closes the channel,
+     * so the curl thread reads them only after the end of the body.
+     */
+    @Volatile
+    var trailers: Headers? = null
+
+    override val isClosedForWrite: Boolean
+        get() = isClosed || failure != null
+
+    override val closedCause: Throwable?
+        get() = failure
+
+    override val writeBuffer: Sink
+        get() {
+            if (isClosedForWrite) throw ClosedWriteChannelException(failure)
+            return _writeBuffer
+        }
+
+    override suspend fun flush() {
+        failure?.let { throw ClosedWriteChannelException(it) }
+        val isFull = moveToFlushed()
+        if (!isFull) return
+
+        suspendCancellableCoroutine { continuation ->
+            val resumeNow = synchronized(lock) {
+                val canResume = flushed.size < MAX_FLUSHED_SIZE || failure != null
+                if (!canResume) producer = continuation
+                canResume
+            }
+            if (resumeNow) continuation.resume(Unit)
+        }
+        failure?.let { throw ClosedWriteChannelException(it) }
+    }
+
+    override suspend fun flushAndClose() {
+        if (isClosedForWrite) return
+        moveToFlushed(close = true)
+    }
+
+    override fun cancel(cause: Throwable?) {
+        if (isClosedForWrite) return
+        val closeCause = cause ?: IOException("Channel was cancelled")
+        val (waitingProducer, unpause) = synchronized(lock) {
+            failure = closeCause
+            flushed.clear()
+            (producer to onReaderUnpause).also {
+                producer = null
+                onReaderUnpause = null
+            }
+        }
+        waitingProducer?.resumeWithException(ClosedWriteChannelException(closeCause))
+        unpause?.invoke()
+    }
+
+    /**
+     * Copies up to [size] flushed bytes to the [buffer] on the curl thread.
+     * Returns `0` at the end of the body, or `null` if there are no bytes yet and libcurl should pause the upload:
+     * [onUnpause] is called once more bytes are flushed.
+     *
+     * @throws Throwable the cause of the cancelled body.
+     */
+    fun readTo(buffer: CPointer<ByteVar>, size: Int, onUnpause: () -> Unit): Int? {
+        val (count, waitingProducer) = synchronized(lock) {
+            failure?.let { throw it }
+            if (flushed.exhausted()) {
+                if (isClosed) return 0
+                onReaderUnpause = onUnpause
+                return null
+            }
+
+            val count = flushed.readAvailable(buffer, 0, size)
+            val waitingProducer = producer.takeIf { flushed.size < MAX_FLUSHED_SIZE }
+            if (waitingProducer != null) producer = null
+            count to waitingProducer
+        }
+        waitingProducer?.resume(Unit)
+        return count
+    }
+
+    /**
+     * Moves the written bytes to the buffer drained by libcurl and resumes a paused upload.
+     * Returns `true` if the buffer is full.
+     */
+    private fun moveToFlushed(close: Boolean = false): Boolean {
+        val (isFull, unpause) = synchronized(lock) {
+            flushed.transferFrom(_writeBuffer)
+            // Closed together with the last bytes, so the reader can't see the end of the body before them
+            if (close) isClosed = true
+            (flushed.size >= MAX_FLUSHED_SIZE) to onReaderUnpause.also { onReaderUnpause = null }
+        }
+        unpause?.invoke()
+        return isFull
+    }
+}
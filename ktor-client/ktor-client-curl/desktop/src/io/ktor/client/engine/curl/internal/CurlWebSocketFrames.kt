@@ -0,0 +1,82 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.internal
+
+import io.ktor.websocket.*
+import kotlinx.cinterop.ExperimentalForeignApi
+import libcurl.*
+import kotlin.random.Random
+
+// libcurl sends the bytes as they are in CURLWS_RAW_MODE, which takes no flags
+internal const val RAW_MODE_FLAGS = 0
+
+internal const val FIN_BIT = 0x80
+internal const val MASK_KEY_SIZE = 4
+private const val MASK_BIT = 0x80
+
+@OptIn(ExperimentalForeignApi::class)
+internal fun Frame.curlFlags(): Int {
+    val typeFlag = when (frameType) {
+        FrameType.BINARY -> CURLWS_BINARY
+        FrameType.TEXT -> CURLWS_TEXT
+        FrameType.PING -> CURLWS_PING
+        FrameType.PONG -> CURLWS_PONG
+        FrameType.CLOSE -> CURLWS_CLOSE
+    }
+    return if (fin) typeFlag else typeFlag or CURLWS_CONT
+}
+
+/**
+ * Encodes the [frame] with a masked payload for `CURLWS_RAW_MODE`, keeping the RSV bits set by extensions.
+ */
+internal fun encodeFrame(frame: Frame): ByteArray {
+    val maskKey = Random.nextBytes(MASK_KEY_SIZE)
+    val firstByte = (if (frame.fin) FIN_BIT else 0) or
+        (if (frame.rsv1) 0x40 else 0) or
+        (if (frame.rsv2) 0x20 else 0) or
+        (if (frame.rsv3) 0x10 else 0) or
+        frame.frameType.opcode
+    val header = encodeHeader(firstByte, frame.data.size.toLong(), maskKey)
+
+    val encoded = header.copyOf(header.size + frame.data.size)
+    frame.data.copyInto(encoded, destinationOffset = header.size)
+    encoded.mask(maskKey, start = header.size)
+    return encoded
+}
+
+/**
+ * Encodes the header of a client frame with a payload of [length] bytes masked with the [maskKey],
+ * see RFC 6455, section 5.2.
+ */
+internal fun encodeHeader(firstByte: Int, length: Long, maskKey: ByteArray): ByteArray {
+    val lengthSize = when {
+        length < 126 -> 0
+        length <= 0xffff -> 2
+        else -> 8
+    }
+    val header = ByteArray(2 + lengthSize + MASK_KEY_SIZE)
+    header[0] = firstByte.toByte()
+    val lengthBits = when (lengthSize) {
+        0 -> length.toInt()
+        2 -> 126
+        else -> 127
+    }
+    header[1] = (MASK_BIT or lengthBits).toByte()
+    for (index in 0 until lengthSize) {
+        header[2 + index] = (length ushr (8 * (lengthSize - 1 - index))).toByte()
+    }
+    maskKey.copyInto(header, destinationOffset = 2 + lengthSize)
+    return header
+}
+
+/**
+ * Masks the payload bytes from [start] to [end] with the [maskKey], where [start] is at [payloadOffset] of the payload.
+ */
+internal fun ByteArray.mask(maskKey: ByteArray, start: Int = 0, end: Int = size, payloadOffset: Long = 0) {
+    for (index in start until end) {
+        val keyIndex = ((payloadOffset + index - start) % MASK_KEY_SIZE).toInt()
+        this[index] = (this[index].toInt() xor maskKey[keyIndex].toInt()).toByte()
+    }
+}
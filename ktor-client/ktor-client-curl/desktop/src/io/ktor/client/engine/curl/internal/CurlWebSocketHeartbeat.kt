@@ -0,0 +1,135 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.internal
+
+import kotlin.time.TimeSource
+
+// Deadlines are rounded up to ticks, so the sessions due at the same tick are checked together
+private const val TICK_MILLIS = 100L
+
+// Covers 51.2 seconds, later deadlines wait in their slot for another turn of the wheel
+private const val WHEEL_SIZE = 512
+
+/**
+ * Sends heartbeat pings to idle WebSocket sessions and fails the sessions that don't respond, on the curl thread only.
+ *
+ * The deadlines are kept in a hashed timer wheel, so a check costs the same for any number of sessions
+ * and no coroutine or timer is needed per session. A session is checked every [intervalMillis]:
+ * if nothing was received since the previous check, it is sent a Ping and checked again after [timeoutMillis],
+ * when [onTimeout] is called unless anything has been received by then.
+ * Receiving is paused while a session doesn't read its frames, so such a session is never considered unresponsive.
+ */
+internal class CurlWebSocketHeartbeat(
+    intervalMillis: Long,
+    timeoutMillis: Long,
+    private val isActive: (CurlWebSocketResponseBody) -> Boolean,
+    private val isReceivePaused: (CurlWebSocketResponseBody) -> Boolean,
+    private val onTimeout: (CurlWebSocketResponseBody) -> Unit,
+) {
+    private class Entry(val websocket: CurlWebSocketResponseBody) {
+        var deadlineTick: Long = 0
+        var pingTick: Long? = null
+    }
+
+    private val intervalTicks = ticks(intervalMillis)
+    private val timeoutTicks = ticks(timeoutMillis)
+
+    private val start = TimeSource.Monotonic.markNow()
+    private val slots = Array(WHEEL_SIZE) { mutableListOf<Entry>() }
+    private val dueEntries = mutableListOf<Entry>()
+    private var size = 0
+    private var lastTick = currentTick()
+
+    fun isEmpty(): Boolean = size == 0
+
+    /**
+     * Starts checking the [websocket] once its handshake is complete.
+     */
+    fun add(websocket: CurlWebSocketResponseBody) {
+        websocket.receivedSinceHeartbeat = false
+        schedule(Entry(websocket), currentTick() + intervalTicks)
+    }
+
+    /**
+     * Checks the sessions whose deadlines have passed since the previous call.
+     */
+    fun advance() {
+        val nowTick = currentTick()
+        if (size == 0 || nowTick == lastTick) {
+            lastTick = nowTick
+            return
+        }
+
+        // A full turn visits every slot, so a long stall of the loop doesn't need a turn per tick
+        val firstTick = maxOf(lastTick + 1, nowTick - WHEEL_SIZE + 1)
+        for (tick in firstTick..nowTick) {
+            val slot = slots[slotIndex(tick)]
+            var index = 0
+            while (index < slot.size) {
+                val entry = slot[index]
+                if (entry.deadlineTick > nowTick) {
+                    index++
+                    continue
+                }
+                // The order within a slot doesn't matter, so the last entry takes the place of the removed one
+                slot[index] = slot[slot.lastIndex]
+                slot.removeAt(slot.lastIndex)
+                size--
+                dueEntries.add(entry)
+            }
+        }
+        lastTick = nowTick
+
+        for (entry in dueEntries) {
+            checkSession(entry, nowTick)
+        }
+        dueEntries.clear()
+    }
+
+    /**
+     * Returns the time until the next tick, which bounds how long the loop may wait in `curl_multi_poll`.
+     */
+    fun millisUntilNextTick(): Int {
+        val elapsed = start.elapsedNow().inWholeMilliseconds
+        return (TICK_MILLIS - elapsed % TICK_MILLIS).toInt()
+    }
+
+    private fun checkSession(entry: Entry, nowTick: Long) {
+        val websocket = entry.websocket
+        val pingTick = entry.pingTick
+        when {
+            !isActive(websocket) -> {}
+
+            websocket.receivedSinceHeartbeat || isReceivePaused(websocket) -> {
+                websocket.receivedSinceHeartbeat = false
+                entry.pingTick = null
+                val nextTick = if (pingTick != null) pingTick + intervalTicks else nowTick + intervalTicks
+                schedule(entry, maxOf(nextTick, nowTick + 1))
+            }
+
+            pingTick != null -> onTimeout(websocket)
+
+            websocket.trySendPing() -> {
+                entry.pingTick = nowTick
+                schedule(entry, nowTick + timeoutTicks)
+            }
+
+            // A streamed frame is being queued, the ping follows it
+            else -> schedule(entry, nowTick + 1)
+        }
+    }
+
+    private fun schedule(entry: Entry, deadlineTick: Long) {
+        entry.deadlineTick = deadlineTick
+        slots[slotIndex(deadlineTick)].add(entry)
+        size++
+    }
+
+    private fun currentTick(): Long = start.elapsedNow().inWholeMilliseconds / TICK_MILLIS
+
+    private fun slotIndex(tick: Long): Int = (tick % WHEEL_SIZE).toInt()
+
+    private fun ticks(millis: Long): Long = maxOf((millis + TICK_MILLIS - 1) / TICK_MILLIS, 1)
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.internal
+
+import io.ktor.websocket.*
+import kotlinx.atomicfu.atomic
+import kotlinx.coroutines.*
+import kotlinx.coroutines.channels.*
+import kotlinx.coroutines.selects.SelectClause2
+import kotlinx.coroutines.sync.Mutex
+import kotlinx.coroutines.sync.withLock
+
+private val CLOSED: (Throwable?) -> Unit = {}
+private val CLOSED_INVOKED: (Throwable?) -> Unit = {}
+
+/**
+ * The `outgoing` channel of a WebSocket session, which puts the frames to the send queue in the sender's coroutine.
+ *
+ * The curl loop drains the send queues of all the sessions, so a session needs neither a buffer of frames
+ * nor a coroutine moving them to the queue. [send] suspends while the queue is full,
+ * and [trySend] fails instead. The [lock] keeps frames from getting between the parts of a streamed frame.
+ * The session is closed once a Close frame is taken by libcurl or the channel is closed, see [onClose].
+ *
+ * A `select` clause needs a real channel, so [onSend] starts a rendezvous channel with a coroutine
+ * draining it to the queue. From then on, all the frames of the session go through it to keep their order.
+ */
+internal class CurlWebSocketOutgoing(
+    private val websocket: CurlWebSocketResponseBody,
+    private val lock: Mutex,
+    private val scope: CoroutineScope,
+    private val onClose: (Throwable?) -> Unit,
+) : SendChannel<Frame> {
+    private val onCloseHandler = atomic<((Throwable?) -> Unit)?>(null)
+    private val closed = atomic(false)
+    private val closedCause = atomic<Throwable?>(null)
+    private val selectChannel = atomic<Channel<Frame>?>(null)
+
+    @DelicateCoroutinesApi
+    override val isClosedForSend: Boolean
+        get() = closed.value
+
+    override val onSend: SelectClause2<Frame, SendChannel<Frame>>
+        get() = (selectChannel.value ?: startSelectChannel()).onSend
+
+    private fun startSelectChannel(): Channel<Frame> {
+        val channel = Channel<Frame>()
+        if (!selectChannel.compareAndSet(null, channel)) return selectChannel.value!!
+        if (closed.value) channel.close(closedCause.value)
+
+        scope.launch {
+            try {
+                for (frame in channel) enqueue(frame)
+            } catch (cause: Throwable) {
+                channel.close(cause)
+            }
+        }
+        return channel
+    }
+
+    @OptIn(InternalCoroutinesApi::class)
+    override fun trySend(element: Frame): ChannelResult<Unit> {
+        if (closed.value) return ChannelResult.closed(closedCause.value)
+        selectChannel.value?.let { return it.trySend(element) }
+        if (!lock.tryLock()) return ChannelResult.failure()
+
+        val queued = try {
+            websocket.sendQueue.trySend(flagsOf(element), payloadOf(element))
+        } catch (cause: Throwable) {
+            return ChannelResult.closed(cause)
+        } finally {
+            lock.unlock()
+        }
+        if (!queued) return ChannelResult.failure()
+
+        if (element.frameType == FrameType.CLOSE) {
+            scope.launch { lock.withLock { closeAfterFlush() } }
+        }
+        return ChannelResult.success(Unit)
+    }
+
+    override suspend fun send(element: Frame) {
+        if (closed.value) throw closedCause.value ?: ClosedSendChannelException("Channel was closed for send")
+
+        val channel = selectChannel.value
+        if (channel != null) channel.send(element) else enqueue(element)
+    }
+
+    private suspend fun enqueue(element: Frame) {
+        lock.withLock {
+            websocket.sendQueue.send(flagsOf(element), payloadOf(element))
+            if (element.frameType == FrameType.CLOSE) closeAfterFlush()
+        }
+    }
+
+    private suspend fun closeAfterFlush() {
+        // The frame has to reach libcurl before the easy handle is removed
+        websocket.sendQueue.flush()
+        close(null)
+    }
+
+    private fun flagsOf(frame: Frame): Int = if (websocket.isRawMode) RAW_MODE_FLAGS else frame.curlFlags()
+
+    private fun payloadOf(frame: Frame): ByteArray = if (websocket.isRawMode) encodeFrame(frame) else frame.data
+
+    override fun close(cause: Throwable?): Boolean {
+        if (!closed.compareAndSet(false, true)) {
+            return false
+        }
+
+        closedCause.value = cause
+        selectChannel.value?.close(cause)
+        onClose(cause)
+        closeAndCheckHandler()
+
+        return true
+    }
+
+    @ExperimentalCoroutinesApi
+    override fun invokeOnClose(handler: (cause: Throwable?) -> Unit) {
+        if (onCloseHandler.compareAndSet(null, handler)) {
+            return
+        }
+
+        if (onCloseHandler.value === CLOSED) {
+            require(onCloseHandler.compareAndSet(CLOSED, CLOSED_INVOKED))
+            handler(closedCause.value)
+            return
+        }
+
+        val message = if (onCloseHandler.value === CLOSED_INVOKED) {
+            "Another handler was already registered and successfully invoked"
+        } else {
+            "Another handler was already registered: ${onCloseHandler.value}"
+        }
+        throw IllegalStateException(message)
+    }
+
+    private fun closeAndCheckHandler() {
+        while (true) {
+            val handler = onCloseHandler.value
+            if (handler === CLOSED_INVOKED) break
+            if (handler == null) {
+                if (onCloseHandler.compareAndSet(null, CLOSED)) break
+                continue
+            }
+
+            require(onCloseHandler.compareAndSet(handler, CLOSED_INVOKED))
+            handler(closedCause.value)
+            break
+        }
+    }
+}
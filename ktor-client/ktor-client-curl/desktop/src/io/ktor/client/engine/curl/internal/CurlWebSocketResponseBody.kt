@@ -4,64 +4,157 @@
 
 package io.ktor.client.engine.curl.internal
 
+import io.ktor.client.engine.curl.*
 import io.ktor.client.engine.curl.internal.Libcurl.WRITEFUNC_ERROR
+import io.ktor.client.engine.curl.internal.Libcurl.WRITEFUNC_PAUSE
 import io.ktor.utils.io.*
 import io.ktor.websocket.*
 import kotlinx.atomicfu.atomic
 import kotlinx.cinterop.*
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.cancel
 import kotlinx.coroutines.channels.Channel
 import kotlinx.coroutines.channels.ReceiveChannel
-import kotlinx.io.Buffer
-import kotlinx.io.readByteArray
+import kotlinx.coroutines.launch
+import kotlinx.io.EOFException
 import libcurl.*
+import platform.posix.memcpy
 import platform.posix.size_t
+import kotlin.concurrent.Volatile
+import kotlin.coroutines.CoroutineContext
 
 @OptIn(InternalAPI::class, ExperimentalForeignApi::class)
 internal class CurlWebSocketResponseBody(
     internal val easyHandle: EasyHandle,
+    callContext: Job,
     incomingFramesConfig: ChannelConfig,
     var maxFrameSize: Long,
-) : CurlResponseBodyData {
+    private val onPause: () -> Unit,
+    private val onUnpause: () -> Unit,
+    onFramesQueued: (CurlWebSocketResponseBody) -> Unit,
+    val isRawMode: Boolean,
+    streamMessages: Boolean,
+) : CurlResponseBodyData, CoroutineScope {
+
+    private val job = Job(callContext)
+    override val coroutineContext: CoroutineContext = job
 
     private val closed = atomic(false)
-    private val _incoming = run {
-        require(!incomingFramesConfig.canSuspend) {
-            "Curl Client does not support SUSPEND overflow strategy for incoming channel"
-        }
-        Channel.from<Frame>(incomingFramesConfig)
-    }
+    private val _incoming = Channel.from<Frame>(incomingFramesConfig)
+    private val canSuspend = incomingFramesConfig.canSuspend
+
+    @Volatile
+    private var paused = false
 
     val incoming: ReceiveChannel<Frame>
         get() = _incoming
 
+    /**
+     * Data messages whose content is written chunk by chunk as it arrives,
+     * or `null` if data frames are assembled as a whole and sent to [incoming].
+     */
+    private val _messages = if (streamMessages) Channel.from<CurlWebSocketMessage>(incomingFramesConfig) else null
+
+    val messages: ReceiveChannel<CurlWebSocketMessage>?
+        get() = _messages
+
+    /**
+     * The content of the message that is being received, accessed on the curl thread only.
+     */
+    private var messageContent: ByteChannel? = null
+
+    /**
+     * Outgoing frames sent by the curl loop.
+     */
+    val sendQueue = CurlWebSocketSendQueue { onFramesQueued(this) }
+
+    /**
+     * The bytes received in `CURLWS_RAW_MODE`, which are decoded into frames by ktor instead of libcurl,
+     * or `null` if libcurl decodes the frames.
+     */
+    private val rawBody = if (isRawMode) CurlHttpResponseBody(callContext, onPause, onUnpause) else null
+
+    init {
+        rawBody?.let { body -> launch { readRawFrames(body.bodyChannel) } }
+    }
+
     /**
      * Exception that occurred during frame processing, to be propagated when closing the channel.
      */
     private var pendingException: Throwable? = null
 
     /**
-     * Buffer for collecting WebSocket frame data that libcurl splits across multiple write callbacks
+     * Data of a WebSocket frame that libcurl splits across multiple write callbacks
      * due to its internal buffering (~4KB chunks). `null` when no frame is being collected.
+     * It is allocated with the size of the whole frame on the first chunk, so each chunk is copied once to its place.
      */
-    private var frameDataBuffer: Buffer? = null
+    private var frameData: ByteArray? = null
+
+    /**
+     * Whether anything was received since the last check of [CurlWebSocketHeartbeat], accessed on the curl thread only.
+     */
+    var receivedSinceHeartbeat: Boolean = false
+
+    /**
+     * Queues an empty Ping frame of the heartbeat. Called on the curl thread.
+     * Returns `false` if the frame can't be queued now, see [CurlWebSocketSendQueue.trySendControlFrame].
+     */
+    fun trySendPing(): Boolean = if (isRawMode) {
+        sendQueue.trySendControlFrame(RAW_MODE_FLAGS, encodeFrame(Frame.Ping(EMPTY_PAYLOAD)))
+    } else {
+        sendQueue.trySendControlFrame(CURLWS_PING, EMPTY_PAYLOAD)
+    }
 
     override fun onBodyChunkReceived(buffer: CPointer<ByteVar>, size: size_t, count: size_t): size_t {
         if (closed.value) return 0.convert()
+        receivedSinceHeartbeat = true
+        rawBody?.let { return it.onBodyChunkReceived(buffer, size, count) }
+        if (paused) {
+            onPause()
+            return WRITEFUNC_PAUSE
+        }
 
         val meta = curl_ws_meta(easyHandle)?.pointed ?: return WRITEFUNC_ERROR
         val chunkSize = meta.len.toInt()
-        val chunkData = buffer.readBytes(chunkSize)
 
-        return if (processFrameChunk(chunkData, meta)) chunkSize.convert() else WRITEFUNC_ERROR
+        return if (processFrameChunk(buffer, chunkSize, meta)) chunkSize.convert() else WRITEFUNC_ERROR
+    }
+
+    /**
+     * Decodes the frames received in `CURLWS_RAW_MODE`, keeping their RSV bits for the extensions.
+     * The [input] is paused while the consumer lags behind, so a slow consumer holds back the server.
+     */
+    private suspend fun readRawFrames(input: ByteReadChannel) {
+        var lastOpcode = 0
+        try {
+            while (true) {
+                val frame = input.readFrame(maxFrameSize, lastOpcode)
+                if (!frame.frameType.controlFrame) {
+                    lastOpcode = if (frame.fin) 0 else frame.frameType.opcode
+                }
+                _incoming.send(frame)
+            }
+        } catch (cause: CancellationException) {
+            throw cause
+        } catch (_: EOFException) {
+            // the connection is closed, the body is closed by the transfer
+        } catch (cause: Throwable) {
+            close(cause)
+        }
     }
 
-    private fun processFrameChunk(chunk: ByteArray, meta: curl_ws_frame): Boolean {
+    /**
+     * Handles a chunk of a frame described by the [meta] of `curl_ws_meta`.
+     */
+    private fun processFrameChunk(buffer: CPointer<ByteVar>, chunkSize: Int, meta: curl_ws_frame): Boolean {
         val flags = meta.flags
-        return if (isControlFrame(flags)) {
-            handleIncomingFrame(controlFrame(chunk, flags))
-        } else {
+        val messages = _messages
+        return when {
+            isControlFrame(flags) -> handleIncomingFrame(controlFrame(buffer.readBytes(chunkSize), flags))
+            messages != null -> handleMessageChunk(buffer, chunkSize, meta, messages)
             // Data frames (text/binary) may be split across callbacks
-            handleDataFrameChunk(chunk, meta)
+            else -> handleDataFrameChunk(buffer, chunkSize, meta)
         }
     }
 
@@ -70,35 +163,38 @@ internal class CurlWebSocketResponseBody(
     }
 
     /** Handles data frame chunks, collecting them if they're split across multiple callbacks. */
-    private fun handleDataFrameChunk(chunk: ByteArray, meta: curl_ws_frame): Boolean {
+    private fun handleDataFrameChunk(buffer: CPointer<ByteVar>, chunkSize: Int, meta: curl_ws_frame): Boolean {
         val flags = meta.flags
         val offset = meta.offset
         val bytesLeft = meta.bytesleft
 
-        val totalFrameSize = offset + chunk.size + bytesLeft
-        if (totalFrameSize > maxFrameSize) {
-            frameDataBuffer = null
+        val totalFrameSize = offset + chunkSize + bytesLeft
+        // A frame is delivered as a single array, so it can't be larger than an array either
+        if (totalFrameSize > maxFrameSize || totalFrameSize > Int.MAX_VALUE) {
+            frameData = null
             pendingException = FrameTooBigException(totalFrameSize)
             return false
         }
 
         // Fast path: complete frame in a single chunk
         if (offset == 0L && bytesLeft == 0L) {
-            return handleIncomingFrame(dataFrame(chunk, flags))
+            return handleIncomingFrame(dataFrame(buffer.readBytes(chunkSize), flags))
         }
 
-        // First chunk of a multi-chunk frame: initialize buffer
+        // First chunk of a multi-chunk frame: allocate the whole frame
         if (offset == 0L) {
-            frameDataBuffer = Buffer()
+            frameData = ByteArray(totalFrameSize.toInt())
         }
 
-        val buffer = frameDataBuffer ?: return false
-        buffer.write(chunk)
+        val data = frameData ?: return false
+        if (data.size.toLong() != totalFrameSize) return false
+        if (chunkSize > 0) {
+            data.usePinned { memcpy(it.addressOf(offset.toInt()), buffer, chunkSize.convert()) }
+        }
 
-        // Last chunk: complete and emit the frame
+        // Last chunk: emit the frame
         if (bytesLeft == 0L) {
-            val data = buffer.readByteArray()
-            frameDataBuffer = null
+            frameData = null
             return handleIncomingFrame(dataFrame(data, flags))
         }
 
@@ -106,17 +202,99 @@ internal class CurlWebSocketResponseBody(
         return true
     }
 
-    private fun handleIncomingFrame(frame: Frame?): Boolean =
-        if (frame != null) _incoming.trySend(frame).isSuccess else false
+    /**
+     * Writes a chunk of a data frame to the content of the current message, starting a message with its first chunk.
+     * The content is closed after the last chunk of the final frame, so fragments make up a single message.
+     * A content that is cancelled by its reader is skipped until the end of the message.
+     */
+    private fun handleMessageChunk(
+        buffer: CPointer<ByteVar>,
+        chunkSize: Int,
+        meta: curl_ws_frame,
+        messages: Channel<CurlWebSocketMessage>,
+    ): Boolean {
+        val flags = meta.flags
+        val content = messageContent ?: ByteChannel().also { content ->
+            val frameType = if (flags and CURLWS_TEXT != 0) FrameType.TEXT else FrameType.BINARY
+            if (!handleIncomingMessage(CurlWebSocketMessage(frameType, content), messages)) return false
+            messageContent = content
+        }
+
+        if (chunkSize > 0 && !content.isClosedForWrite) {
+            content.writeBuffer.writeFully(buffer, 0L, chunkSize.toLong())
+            content.flushWriteBuffer()
+        }
+
+        when {
+            meta.bytesleft == 0L && flags and CURLWS_CONT == 0 -> {
+                messageContent = null
+                content.close()
+            }
+
+            // The message may be waiting for a slot in the channel already
+            !paused && !content.isClosedForWrite && !content.hasFreeSpace -> pauseUntil { content.awaitFreeSpace() }
+        }
+        return true
+    }
+
+    private fun handleIncomingMessage(
+        message: CurlWebSocketMessage,
+        messages: Channel<CurlWebSocketMessage>,
+    ): Boolean {
+        val result = messages.trySend(message)
+        if (result.isSuccess) return true
+        if (!canSuspend || result.isClosed) return false
+
+        pauseUntil { messages.send(message) }
+        return true
+    }
+
+    private fun handleIncomingFrame(frame: Frame?): Boolean {
+        if (frame == null) return false
+        val result = _incoming.trySend(frame)
+        if (result.isSuccess) return true
+        if (!canSuspend || result.isClosed) return false
+
+        pauseUntil { _incoming.send(frame) }
+        return true
+    }
+
+    /**
+     * Runs the [block] in a coroutine and pauses receiving until it completes, for example until the consumer takes
+     * a frame from the full incoming channel, so a slow consumer holds back the server through TCP flow control.
+     */
+    private fun pauseUntil(block: suspend () -> Unit) {
+        paused = true
+        launch {
+            try {
+                block()
+            } catch (cause: CancellationException) {
+                throw cause
+            } catch (_: Throwable) {
+                // no op, the closed channel fails the next write on cURL thread
+            } finally {
+                paused = false
+                onUnpause()
+            }
+        }
+    }
 
     override fun close(cause: Throwable?) {
         if (!closed.compareAndSet(expect = false, update = true)) return
-        frameDataBuffer = null
+        frameData = null
         val actualCause = pendingException ?: cause
+        messageContent?.close(actualCause ?: EOFException("WebSocket session is closed before the end of the message"))
+        messageContent = null
+        _messages?.close(actualCause)
         _incoming.close(actualCause)
+        sendQueue.close(actualCause)
+        rawBody?.close(actualCause)
+        cancel(cause as? CancellationException ?: CancellationException(cause))
     }
 }
 
+private val EMPTY_PAYLOAD = ByteArray(0)
+
 @OptIn(ExperimentalForeignApi::class)
 private fun controlFrame(data: ByteArray, flags: Int): Frame? = when {
     (flags and CURLWS_PING != 0) -> Frame.Ping(data)
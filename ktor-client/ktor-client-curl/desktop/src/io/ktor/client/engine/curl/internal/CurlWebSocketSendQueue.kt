@@ -0,0 +1,193 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.internal
+
+import io.ktor.utils.io.locks.*
+import kotlinx.coroutines.CancellableContinuation
+import kotlinx.coroutines.suspendCancellableCoroutine
+import kotlinx.io.IOException
+import kotlin.concurrent.Volatile
+import kotlin.coroutines.resume
+
+// The producer waits for libcurl once this many bytes are queued, so it can't outrun the socket
+private const val MAX_QUEUED_BYTES = 1024 * 1024L
+
+private val EMPTY_DATA = ByteArray(0)
+
+/**
+ * A frame queued for sending with `curl_ws_send`, or a part of a streamed frame, which is sent the same way.
+ * A streamed frame starts with an entry without data, where [frameLength] is the length of the whole payload
+ * to be passed to `curl_ws_start_frame`.
+ */
+internal class OutgoingWebSocketFrame(
+    val flags: Int,
+    val data: ByteArray,
+    val size: Int = data.size,
+    val frameLength: Long? = null,
+) {
+    /**
+     * The number of bytes libcurl has already taken, accessed on the curl thread only.
+     */
+    var offset: Int = 0
+}
+
+/**
+ * Outgoing frames of a WebSocket session, drained by the curl loop.
+ *
+ * Frames don't need a task and a wakeup each: [onFramesQueued] is called only when the queue was empty,
+ * and the curl loop sends all the queued frames at once, keeping a partially sent frame on `CURLE_AGAIN`.
+ * The producer suspends in [send] while the queue is full, so the `outgoing` channel is backpressured by the socket.
+ */
+internal class CurlWebSocketSendQueue(private val onFramesQueued: () -> Unit) {
+    private val lock = SynchronizedObject()
+
+    // Guarded by the lock
+    // A ring buffer, so queuing a frame doesn't allocate once the queue has grown
+    private val frames = ArrayDeque<OutgoingWebSocketFrame>()
+    private var queuedBytes = 0L
+    private var producer: CancellableContinuation<Unit>? = null
+    private var producerAwaitsEmptyQueue = false
+
+    // The payload bytes of a streamed frame that are not queued yet, no other frame may be queued before them
+    private var streamedBytesLeft = 0L
+
+    @Volatile
+    private var failure: Throwable? = null
+
+    /**
+     * Queues a frame and suspends while the queue is full.
+     *
+     * @throws Throwable the cause of the closed session.
+     */
+    suspend fun send(flags: Int, data: ByteArray, size: Int = data.size) {
+        enqueue(OutgoingWebSocketFrame(flags, data, size))
+    }
+
+    /**
+     * Queues the header of a frame with a payload of [length] bytes.
+     * The payload has to follow in [send] calls with the same [flags] before any other frame.
+     * In `CURLWS_RAW_MODE`, the encoded [header] is sent as is instead.
+     *
+     * @throws Throwable the cause of the closed session.
+     */
+    suspend fun startFrame(flags: Int, length: Long, header: ByteArray? = null) {
+        val frame = if (header != null) {
+            OutgoingWebSocketFrame(flags, header)
+        } else {
+            OutgoingWebSocketFrame(flags, EMPTY_DATA, frameLength = length)
+        }
+        enqueue(frame, streamedLength = length)
+    }
+
+    /**
+     * Queues a frame unless the queue is full. Returns `false` if the frame is not queued.
+     *
+     * @throws Throwable the cause of the closed session.
+     */
+    fun trySend(flags: Int, data: ByteArray): Boolean {
+        val wasEmpty = synchronized(lock) {
+            failure?.let { throw it }
+            if (queuedBytes >= MAX_QUEUED_BYTES) return false
+            addLast(OutgoingWebSocketFrame(flags, data))
+        }
+        if (wasEmpty) onFramesQueued()
+        return true
+    }
+
+    /**
+     * Queues a control frame without waiting for space in the queue. Called on the curl thread.
+     * Returns `false` if the session is closed or the payload of a streamed frame is not queued completely yet,
+     * since the frame can't get between its parts.
+     */
+    fun trySendControlFrame(flags: Int, data: ByteArray): Boolean {
+        val wasEmpty = synchronized(lock) {
+            if (failure != null || streamedBytesLeft > 0) return false
+            addLast(OutgoingWebSocketFrame(flags, data))
+        }
+        if (wasEmpty) onFramesQueued()
+        return true
+    }
+
+    private suspend fun enqueue(frame: OutgoingWebSocketFrame, streamedLength: Long = 0) {
+        val (wasEmpty, isFull) = synchronized(lock) {
+            failure?.let { throw it }
+            val wasEmpty = addLast(frame)
+            streamedBytesLeft = if (streamedLength > 0) streamedLength else maxOf(streamedBytesLeft - frame.size, 0)
+            wasEmpty to (queuedBytes >= MAX_QUEUED_BYTES)
+        }
+        if (wasEmpty) onFramesQueued()
+        if (isFull) awaitProducerResumed(untilEmpty = false)
+    }
+
+    // Returns whether the queue was empty, called under the lock
+    private fun addLast(frame: OutgoingWebSocketFrame): Boolean {
+        val wasEmpty = frames.isEmpty()
+        frames.addLast(frame)
+        queuedBytes += frame.size
+        return wasEmpty
+    }
+
+    /**
+     * Suspends until all the queued frames are taken by libcurl.
+     *
+     * @throws Throwable the cause of the closed session.
+     */
+    suspend fun flush() {
+        awaitProducerResumed(untilEmpty = true)
+    }
+
+    /**
+     * Returns the first frame that is not sent completely, or `null` if the queue is drained.
+     * Called on the curl thread.
+     */
+    fun peek(): OutgoingWebSocketFrame? = synchronized(lock) { frames.firstOrNull() }
+
+    /**
+     * Removes the completely sent [frame] returned by [peek]. Called on the curl thread.
+     */
+    fun remove(frame: OutgoingWebSocketFrame) {
+        val waitingProducer = synchronized(lock) {
+            // The queue is cleared when the session is closed during a send
+            if (frames.firstOrNull() !== frame) return
+            frames.removeFirst()
+            queuedBytes -= frame.size
+            producer.takeIf { canResumeProducer() }?.also { producer = null }
+        }
+        waitingProducer?.resume(Unit)
+    }
+
+    /**
+     * Drops the queued frames and fails the following sends.
+     */
+    fun close(cause: Throwable?) {
+        val waitingProducer = synchronized(lock) {
+            if (failure != null) return
+            failure = cause ?: IOException("WebSocket connection is closed")
+            frames.clear()
+            queuedBytes = 0
+            producer.also { producer = null }
+        }
+        waitingProducer?.resume(Unit)
+    }
+
+    private suspend fun awaitProducerResumed(untilEmpty: Boolean) {
+        suspendCancellableCoroutine { continuation ->
+            val resumeNow = synchronized(lock) {
+                producerAwaitsEmptyQueue = untilEmpty
+                val canResume = canResumeProducer()
+                if (!canResume) producer = continuation
+                canResume
+            }
+            if (resumeNow) continuation.resume(Unit)
+        }
+        failure?.let { throw it }
+    }
+
+    private fun canResumeProducer(): Boolean = when {
+        failure != null -> true
+        producerAwaitsEmptyQueue -> frames.isEmpty()
+        else -> queuedBytes < MAX_QUEUED_BYTES
+    }
+}
@@ -12,26 +12,36 @@ import kotlinx.atomicfu.atomic
 import kotlinx.cinterop.ExperimentalForeignApi
 import kotlinx.coroutines.CoroutineName
 import kotlinx.coroutines.Job
-import kotlinx.coroutines.channels.Channel
 import kotlinx.coroutines.channels.ReceiveChannel
 import kotlinx.coroutines.channels.SendChannel
-import kotlinx.coroutines.launch
+import kotlinx.coroutines.sync.Mutex
+import kotlinx.coroutines.sync.withLock
+import kotlinx.io.EOFException
 import libcurl.*
 import kotlin.coroutines.CoroutineContext
+import kotlin.random.Random
+
+// Parts of a streamed frame are read into arrays of this size
+private const val STREAMED_PART_SIZE = 64 * 1024L
 
 @OptIn(InternalAPI::class, ExperimentalForeignApi::class)
 internal class CurlWebSocketSession(
     private val websocket: CurlWebSocketResponseBody,
     callContext: CoroutineContext,
-    outgoingFramesConfig: ChannelConfig,
     private val curlProcessor: CurlProcessor,
 ) : WebSocketSession, Closeable {
 
     private val closed = atomic(false)
     private val socketJob = Job(callContext[Job])
-    private val _outgoing = Channel.from<Frame>(outgoingFramesConfig)
+
+    // Keeps other frames from getting between the parts of a streamed frame
+    private val sendLock = Mutex()
 
     override val coroutineContext: CoroutineContext = callContext + socketJob + CoroutineName("curl-ws")
+
+    private val _outgoing = CurlWebSocketOutgoing(websocket, sendLock, scope = this) { cause ->
+        if (cause == null) socketJob.complete() else socketJob.completeExceptionally(cause)
+    }
     override var masking: Boolean
         get() = true
         set(_) {}
@@ -48,6 +58,12 @@ internal class CurlWebSocketSession(
     override val outgoing: SendChannel<Frame>
         get() = _outgoing
 
+    /**
+     * Data messages with streamed content, or `null` if they are received as frames in [incoming].
+     */
+    val incomingMessages: ReceiveChannel<CurlWebSocketMessage>?
+        get() = websocket.messages
+
     override val extensions: List<WebSocketExtension<*>>
         get() = emptyList()
 
@@ -55,38 +71,45 @@ internal class CurlWebSocketSession(
         socketJob.invokeOnCompletion {
             close(it)
         }
-
-        launch(CoroutineName("curl-ws-outgoing")) {
-            while (!closed.value) {
-                val frame = _outgoing.receive()
-                sendNextFrame(frame)
-            }
-        }
     }
 
-    private suspend fun sendNextFrame(frame: Frame) {
-        val flags = if (frame.fin) 0 else CURLWS_CONT
-        when (frame.frameType) {
-            FrameType.BINARY -> sendFrame(CURLWS_BINARY or flags, frame.data)
-
-            FrameType.TEXT -> sendFrame(CURLWS_TEXT or flags, frame.data)
-
-            FrameType.PING -> sendFrame(CURLWS_PING or flags, frame.data)
-
-            FrameType.PONG -> sendFrame(CURLWS_PONG or flags, frame.data)
+    /**
+     * Sends a data frame with a payload of [length] bytes read from the [content] part by part,
+     * so the payload is never held in memory as a whole.
+     * The session is closed if the [content] ends early or the send is cancelled,
+     * because the peer expects the rest of the payload.
+     */
+    suspend fun sendStreamed(frameType: FrameType, content: ByteReadChannel, length: Long) {
+        require(length >= 0) { "Frame length must not be negative: $length" }
+        val flags = when (frameType) {
+            FrameType.TEXT -> CURLWS_TEXT
+            FrameType.BINARY -> CURLWS_BINARY
+            else -> throw IllegalArgumentException("Only data frames can be streamed, but got $frameType")
+        }
 
-            FrameType.CLOSE -> {
-                sendFrame(CURLWS_CLOSE or flags, frame.data)
-                close(null)
-                socketJob.complete()
+        sendLock.withLock {
+            val queue = websocket.sendQueue
+            val maskKey = if (websocket.isRawMode) Random.nextBytes(MASK_KEY_SIZE) else null
+            val partFlags = if (maskKey != null) RAW_MODE_FLAGS else flags
+            val header = maskKey?.let { encodeHeader(FIN_BIT or frameType.opcode, length, it) }
+            queue.startFrame(partFlags, length, header)
+            try {
+                var remaining = length
+                while (remaining > 0) {
+                    val part = ByteArray(minOf(remaining, STREAMED_PART_SIZE).toInt())
+                    val size = content.readAvailable(part)
+                    if (size == -1) throw EOFException("Content ended after ${length - remaining} of $length bytes")
+                    maskKey?.let { part.mask(it, end = size, payloadOffset = length - remaining) }
+                    queue.send(partFlags, part, size)
+                    remaining -= size
+                }
+            } catch (cause: Throwable) {
+                socketJob.completeExceptionally(cause)
+                throw cause
             }
         }
     }
 
-    private suspend fun sendFrame(flags: Int, data: ByteArray) {
-        curlProcessor.sendWebSocketFrame(websocket, flags, data)
-    }
-
     override suspend fun flush() = Unit
 
     @Deprecated(
@@ -106,7 +129,7 @@ internal class CurlWebSocketSession(
         if (!closed.compareAndSet(expect = false, update = true)) return
 
         websocket.close(cause)
-        _outgoing.cancel()
+        _outgoing.close(cause)
         curlProcessor.cancelWebSocket(websocket)
     }
 }
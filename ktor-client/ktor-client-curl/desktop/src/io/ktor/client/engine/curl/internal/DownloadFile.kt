@@ -0,0 +1,28 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.internal
+
+import kotlinx.cinterop.CPointer
+import kotlinx.cinterop.ExperimentalForeignApi
+import platform.posix.FILE
+
+/**
+ * Opens the file at [path] for writing a downloaded body from [offset].
+ * The file is truncated when [offset] is zero, otherwise it must already exist and is kept intact.
+ */
+@OptIn(ExperimentalForeignApi::class)
+internal expect fun openDownloadFile(path: String, offset: Long): CPointer<FILE>?
+
+/**
+ * Reserves disk space for a download of [expectedSize] bytes, if known, before the body is written to the [file].
+ */
+@OptIn(ExperimentalForeignApi::class)
+internal expect fun prepareDownloadFile(file: CPointer<FILE>, offset: Long, expectedSize: Long)
+
+/**
+ * Releases the space reserved by [prepareDownloadFile] beyond the [size] bytes actually written to the [file].
+ */
+@OptIn(ExperimentalForeignApi::class)
+internal expect fun trimDownloadFile(file: CPointer<FILE>, size: Long)
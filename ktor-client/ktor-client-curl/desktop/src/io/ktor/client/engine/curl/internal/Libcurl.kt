@@ -10,6 +10,8 @@ import libcurl.CURL_READFUNC_ABORT
 import libcurl.CURL_READFUNC_PAUSE
 import libcurl.CURL_WRITEFUNC_ERROR
 import libcurl.CURL_WRITEFUNC_PAUSE
+import libcurl.CURLWS_NOAUTOPONG
+import libcurl.CURLWS_RAW_MODE
 import platform.posix.size_t
 
 @OptIn(ExperimentalForeignApi::class)
@@ -19,4 +21,7 @@ internal object Libcurl {
 
     val READFUNC_PAUSE: size_t = CURL_READFUNC_PAUSE.convert()
     val READFUNC_ABORT: size_t = CURL_READFUNC_ABORT.convert()
+
+    val WS_RAW_MODE: Long = CURLWS_RAW_MODE.convert()
+    val WS_NOAUTOPONG: Long = CURLWS_NOAUTOPONG.convert()
 }
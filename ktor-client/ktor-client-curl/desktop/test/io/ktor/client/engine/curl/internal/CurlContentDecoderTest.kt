@@ -0,0 +1,48 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.internal
+
+import io.ktor.utils.io.*
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.runBlocking
+import kotlinx.io.readText
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFails
+
+// A final stored deflate block with "Hello", without any header
+private val RAW_DEFLATE_HELLO = byteArrayOf(0x01, 0x05, 0x00, 0xfa.toByte(), 0xff.toByte()) +
+    "Hello".encodeToByteArray()
+
+// The same block in a zlib stream, with the header and the Adler-32 checksum
+private val ZLIB_HELLO = byteArrayOf(0x78, 0x01) + RAW_DEFLATE_HELLO +
+    byteArrayOf(0x05, 0x8c.toByte(), 0x01, 0xf5.toByte())
+
+internal class CurlContentDecoderTest {
+
+    @Test
+    fun `zlib content is decoded`(): Unit = runBlocking {
+        assertEquals("Hello", decode(ZLIB_HELLO))
+    }
+
+    @Test
+    fun `raw deflate content is decoded`(): Unit = runBlocking {
+        assertEquals("Hello", decode(RAW_DEFLATE_HELLO))
+    }
+
+    @Test
+    fun `empty content is decoded`(): Unit = runBlocking {
+        assertEquals("", decode(ByteArray(0)))
+    }
+
+    @Test
+    fun `truncated content fails`(): Unit = runBlocking {
+        assertFails { decode(ZLIB_HELLO.copyOf(ZLIB_HELLO.size - 6)) }
+        assertFails { decode(RAW_DEFLATE_HELLO.copyOf(RAW_DEFLATE_HELLO.size - 2)) }
+    }
+
+    private suspend fun decode(encoded: ByteArray): String =
+        decodeContentOffThread(ByteReadChannel(encoded), Job()).readRemaining().readText()
+}
@@ -0,0 +1,244 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.internal
+
+import io.ktor.client.HttpClient
+import io.ktor.client.engine.curl.Curl
+import io.ktor.client.engine.curl.CurlClientEngineConfig
+import io.ktor.client.engine.curl.CurlProcessor
+import io.ktor.client.engine.curl.test.withRawWebSocketServer
+import io.ktor.client.plugins.websocket.WebSockets
+import io.ktor.client.plugins.websocket.webSocket
+import io.ktor.http.cio.parseHeaders
+import io.ktor.utils.io.*
+import io.ktor.utils.io.core.build
+import io.ktor.websocket.Frame
+import io.ktor.websocket.WebSocketDeflateExtension
+import io.ktor.websocket.writeFrame
+import kotlinx.cinterop.*
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.runBlocking
+import kotlinx.io.readByteArray
+import libcurl.curl_slist_free_all
+import kotlin.coroutines.cancellation.CancellationException
+import kotlin.test.Ignore
+import kotlin.test.Test
+
+private const val OPERATIONS = 10_000
+
+// The largest chunk libcurl passes to a callback, CURL_MAX_WRITE_SIZE
+private const val BODY_CHUNK_SIZE = 16 * 1024
+
+// libcurl fails a request with an unknown scheme before connecting anywhere
+private const val UNSUPPORTED_URL = "unsupported://127.0.0.1/"
+
+// A compressible message, such as a market data update sent over a WebSocket
+private val JSON_MESSAGE = (1..40).joinToString(",", "[", "]") { i ->
+    "{\"symbol\":\"TICK$i\",\"bid\":${100 + i}.25,\"ask\":${100 + i}.75,\"volume\":${1000 * i}}"
+}.encodeToByteArray()
+
+private val RESPONSE_HEADER_LINES = listOf(
+    "HTTP/1.1 200 OK",
+    "Date: Mon, 19 Oct 2026 10:00:00 GMT",
+    "Server: ktor",
+    "Content-Type: application/json; charset=utf-8",
+    "Content-Length: 1024",
+    "Cache-Control: no-cache",
+    "ETag: \"33a64df551425fcc55e4d42a148795d9f25f89d4\"",
+    "Vary: Accept-Encoding",
+    "",
+).map { "$it\r\n".encodeToByteArray() }
+
+/**
+ * Measures the hot paths of the engine in isolation, printing the time, the allocations and the throughput
+ * per operation, so regressions in these paths show up as numbers.
+ * Ignored since the numbers are only meaningful in comparison with a run before a change, run them manually.
+ */
+@Ignore
+@OptIn(ExperimentalForeignApi::class)
+internal class CurlMicrobenchmarks {
+
+    @Test
+    fun `scheduleRequest setup`(): Unit = memScoped {
+        val handler = CurlMultiApiHandler()
+        val transfersRunning = alloc<IntVar>()
+        val cause = CancellationException("Benchmark")
+        try {
+            // The cancelled handle is removed before libcurl starts the transfer
+            microbenchmark("scheduleRequest and cancel", OPERATIONS) {
+                val easyHandle = handler.scheduleRequest(testRequestData(), CompletableDeferred())
+                handler.cancelRequest(easyHandle, cause)
+                handler.perform(transfersRunning)
+            }
+        } finally {
+            handler.close()
+        }
+    }
+
+    @Test
+    fun `onHeadersReceived and header parsing`(): Unit = runBlocking {
+        val request = testRequestData()
+        val body = CurlHttpResponseBody(Job(), onPause = {}, onUnpause = {})
+        val lines = RESPONSE_HEADER_LINES.map { it.pin() }
+        try {
+            microbenchmark("onHeadersReceived and parseHeaders", OPERATIONS) {
+                val response = CurlResponseBuilder(request, CompletableDeferred(), body)
+                val responseRef = response.toStableRef()
+                val responsePointer = responseRef.asCPointer()
+                try {
+                    for (line in lines) {
+                        onHeadersReceived(line.addressOf(0), 1.convert(), line.get().size.convert(), responsePointer)
+                    }
+                } finally {
+                    responseRef.dispose()
+                }
+
+                // As the engine does once the headers are complete
+                val headers = ByteReadChannel(response.headersBytes.build().readByteArray())
+                headers.readLineStrict()
+                parseHeaders(headers).release()
+            }
+        } finally {
+            lines.forEach { it.unpin() }
+            body.close()
+            curl_slist_free_all(request.headers)
+        }
+    }
+
+    @Test
+    fun `onBodyChunkReceived throughput`(): Unit = runBlocking {
+        val body = CurlHttpResponseBody(Job(), onPause = {}, onUnpause = {})
+        val bodyRef = body.toStableRef()
+        val chunk = ByteArray(BODY_CHUNK_SIZE).pin()
+        try {
+            microbenchmark("onBodyChunkReceived", OPERATIONS, bytesPerOperation = BODY_CHUNK_SIZE.toLong()) {
+                onBodyChunkReceived(chunk.addressOf(0), 1.convert(), BODY_CHUNK_SIZE.convert(), bodyRef.asCPointer())
+                body.bodyChannel.discard(BODY_CHUNK_SIZE.toLong())
+            }
+        } finally {
+            chunk.unpin()
+            bodyRef.dispose()
+            body.close()
+        }
+    }
+
+    @Test
+    fun `onBodyChunkRequested throughput`(): Unit = runBlocking {
+        val content = ByteChannel()
+        val requestBody = CurlRequestBodyData(content, Job(), onPause = {}, onUnpause = {})
+        val requestRef = requestBody.toStableRef()
+        val source = ByteArray(BODY_CHUNK_SIZE)
+        val buffer = nativeHeap.allocArray<ByteVar>(BODY_CHUNK_SIZE)
+        try {
+            microbenchmark("onBodyChunkRequested", OPERATIONS, bytesPerOperation = BODY_CHUNK_SIZE.toLong()) {
+                content.writeFully(source)
+                content.flush()
+                // A call reads at most one segment of the channel
+                var remaining = BODY_CHUNK_SIZE
+                while (remaining > 0) {
+                    remaining -= onBodyChunkRequested(buffer, 1.convert(), remaining.convert(), requestRef.asCPointer())
+                        .toInt()
+                }
+            }
+        } finally {
+            nativeHeap.free(buffer)
+            requestRef.dispose()
+            content.cancel()
+        }
+    }
+
+    @Test
+    fun `onBodyChunkRequested from a streamed body`(): Unit = runBlocking {
+        val content = CurlRequestBodyChannel()
+        val requestBody = CurlRequestBodyData(
+            ByteReadChannel.Empty,
+            Job(),
+            onPause = {},
+            onUnpause = {},
+            streamedBody = content
+        )
+        val requestRef = requestBody.toStableRef()
+        val source = ByteArray(BODY_CHUNK_SIZE)
+        val buffer = nativeHeap.allocArray<ByteVar>(BODY_CHUNK_SIZE)
+        try {
+            // As a WriteChannelContent body writes to the channel the engine passes to it
+            microbenchmark("onBodyChunkRequested streamed", OPERATIONS, bytesPerOperation = BODY_CHUNK_SIZE.toLong()) {
+                content.writeFully(source)
+                content.flush()
+                var remaining = BODY_CHUNK_SIZE
+                while (remaining > 0) {
+                    remaining -= onBodyChunkRequested(buffer, 1.convert(), remaining.convert(), requestRef.asCPointer())
+                        .toInt()
+                }
+            }
+        } finally {
+            nativeHeap.free(buffer)
+            requestRef.dispose()
+            content.cancel()
+        }
+    }
+
+    @Test
+    fun `permessage-deflate compression`() {
+        val sender = WebSocketDeflateExtension.install {}
+        val receiver = WebSocketDeflateExtension.install {}
+        val size = JSON_MESSAGE.size.toLong()
+
+        // Later messages refer to the earlier ones in the window kept between messages, as in a real session
+        microbenchmark("deflate $size byte message", OPERATIONS, bytesPerOperation = size) {
+            sender.processOutgoingFrame(Frame.Text(true, JSON_MESSAGE))
+        }
+
+        // The first message of a session doesn't refer to earlier ones, so it can be inflated again and again
+        val compressed = WebSocketDeflateExtension.install {}.processOutgoingFrame(Frame.Text(true, JSON_MESSAGE))
+        println("  $size byte message is sent as ${compressed.data.size} bytes")
+        microbenchmark("inflate $size byte message", OPERATIONS, bytesPerOperation = size) {
+            receiver.processIncomingFrame(compressed)
+        }
+    }
+
+    @OptIn(InternalAPI::class)
+    @Test
+    fun `WebSocket frame assembly`(): Unit = runBlocking {
+        HttpClient(Curl) { install(WebSockets) }.use { client ->
+            for (frameSize in listOf(128, 64 * 1024)) {
+                val frame = Frame.Binary(true, ByteArray(frameSize))
+                // Sends frames until the client goes away, libcurl passes the larger ones to the session in chunks
+                withRawWebSocketServer({ _, output ->
+                    runCatching {
+                        while (true) {
+                            output.writeFrame(frame, masking = false)
+                            output.flush()
+                        }
+                    }
+                }) { url ->
+                    client.webSocket(url) {
+                        microbenchmark(
+                            "receive $frameSize byte frame",
+                            OPERATIONS,
+                            bytesPerOperation = frameSize.toLong()
+                        ) {
+                            incoming.receive()
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    @Test
+    fun `task queue round trip`(): Unit = runBlocking {
+        val processor = CurlProcessor(Job(), CurlClientEngineConfig())
+        try {
+            // Includes scheduling the request, which is measured on its own above
+            microbenchmark("executeRequest round trip through the curl thread", OPERATIONS) {
+                runCatching { processor.executeRequest(testRequestData(UNSUPPORTED_URL)) }
+            }
+        } finally {
+            processor.close()
+        }
+    }
+}
@@ -4,15 +4,11 @@
 
 package io.ktor.client.engine.curl.internal
 
-import io.ktor.util.Attributes
-import io.ktor.utils.io.ByteReadChannel
 import kotlinx.cinterop.ExperimentalForeignApi
 import kotlinx.cinterop.IntVar
 import kotlinx.cinterop.alloc
 import kotlinx.cinterop.memScoped
 import kotlinx.coroutines.CompletableDeferred
-import kotlinx.coroutines.Job
-import libcurl.curl_slist_append
 import kotlin.coroutines.cancellation.CancellationException
 import kotlin.experimental.ExperimentalNativeApi
 import kotlin.native.ref.WeakReference
@@ -44,23 +40,7 @@ internal class CurlMultiApiHandlerTest {
 
     @OptIn(ExperimentalForeignApi::class, ExperimentalNativeApi::class)
     private fun scheduleAndCancel(handler: CurlMultiApiHandler): WeakReference<CurlRequestData> {
-        val request = CurlRequestData(
-            protocol = "http",
-            url = "http://127.0.0.1:1/",
-            method = "GET",
-            headers = checkNotNull(curl_slist_append(null, "Expect:")),
-            proxy = null,
-            content = ByteReadChannel.Empty,
-            contentLength = 0,
-            connectTimeout = null,
-            callContext = Job(),
-            isUpgradeRequest = false,
-            forceProxyTunneling = false,
-            sslVerify = true,
-            caInfo = null,
-            caPath = null,
-            attributes = Attributes(),
-        )
+        val request = testRequestData()
         val requestReference = WeakReference(request)
         val response = CompletableDeferred<CurlSuccess>()
         val easyHandle = handler.scheduleRequest(request, response)
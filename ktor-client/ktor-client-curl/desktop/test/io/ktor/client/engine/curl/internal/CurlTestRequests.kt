@@ -0,0 +1,56 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.internal
+
+import io.ktor.util.Attributes
+import io.ktor.utils.io.ByteReadChannel
+import kotlinx.cinterop.ExperimentalForeignApi
+import kotlinx.coroutines.Job
+import libcurl.curl_slist_append
+
+/**
+ * Creates a plain `GET` request to the [url], as `toCurlRequest` does for a request without any configuration.
+ * The default [url] refuses connections.
+ */
+@OptIn(ExperimentalForeignApi::class)
+internal fun testRequestData(
+    url: String = "http://127.0.0.1:1/",
+    callContext: Job = Job(),
+): CurlRequestData = CurlRequestData(
+    protocol = url.substringBefore(':'),
+    url = url,
+    method = "GET",
+    headers = checkNotNull(curl_slist_append(null, "Expect:")),
+    proxy = null,
+    content = ByteReadChannel.Empty,
+    inMemoryContent = null,
+    uploadFilePath = null,
+    mimeParts = null,
+    streamedContent = null,
+    contentLength = 0,
+    connectTimeout = null,
+    requestTimeout = null,
+    socketTimeout = null,
+    callContext = callContext,
+    isUpgradeRequest = false,
+    forceProxyTunneling = false,
+    sslVerify = true,
+    caInfo = null,
+    caPath = null,
+    unixSocketPath = null,
+    abstractUnixSocket = false,
+    maxSendSpeed = null,
+    maxReceiveSpeed = null,
+    offloadContentDecoding = false,
+    passThroughContentEncoding = false,
+    downloadPath = null,
+    downloadOffset = 0,
+    maxResumeAttempts = 0,
+    sendsTrailers = false,
+    isDuplex = false,
+    isRawWebSocket = false,
+    streamWebSocketMessages = false,
+    attributes = Attributes(),
+)
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.internal
+
+import kotlin.math.roundToLong
+import kotlin.native.runtime.GC
+import kotlin.native.runtime.GCInfo
+import kotlin.native.runtime.NativeRuntimeApi
+import kotlin.time.measureTime
+
+// Allocations are counted between two collections, so the sample has to be small enough not to trigger another one
+internal const val ALLOCATION_SAMPLE_SIZE = 1000
+
+/**
+ * The allocations of an operation, counted by the garbage collector.
+ * [objects] are the objects that became garbage, so the objects an operation keeps alive are not counted.
+ */
+internal class AllocationStats(val objects: Double, val bytes: Double)
+
+internal class MicrobenchmarkResult(
+    val name: String,
+    val nanosPerOperation: Double,
+    val allocations: AllocationStats?,
+    val bytesPerOperation: Long,
+) {
+    override fun toString(): String = buildString {
+        append("$name: ${nanosPerOperation.format()} ns/op")
+        if (allocations != null) {
+            append(", ${allocations.objects.format()} allocations/op, ${allocations.bytes.format()} B/op")
+        } else {
+            append(", allocations n/a")
+        }
+        if (bytesPerOperation > 0) {
+            val bytesPerSecond = bytesPerOperation * 1_000_000_000.0 / nanosPerOperation
+            append(", ${(bytesPerSecond / (1024 * 1024)).format()} MiB/s")
+        }
+    }
+}
+
+/**
+ * Runs the [operation] [operations] times after a warm-up and prints the time and the allocations per operation.
+ * The [operation] may suspend, so a suspending path is measured in the caller's coroutine.
+ * Pass [bytesPerOperation] to also print the throughput of an operation moving data.
+ */
+@OptIn(NativeRuntimeApi::class)
+internal inline fun microbenchmark(
+    name: String,
+    operations: Int,
+    bytesPerOperation: Long = 0,
+    operation: () -> Unit,
+): MicrobenchmarkResult {
+    // Warms up the code paths and the allocator before anything is measured
+    repeat(maxOf(operations / 10, 1)) { operation() }
+
+    val sampleSize = minOf(operations, ALLOCATION_SAMPLE_SIZE)
+    val before = collectGarbage()
+    repeat(sampleSize) { operation() }
+    val allocations = allocationsSince(before, sampleSize)
+
+    val time = measureTime { repeat(operations) { operation() } }
+    val result = MicrobenchmarkResult(
+        name,
+        time.inWholeNanoseconds.toDouble() / operations,
+        allocations,
+        bytesPerOperation
+    )
+    println(result)
+    return result
+}
+
+@NativeRuntimeApi
+internal fun collectGarbage(): GCInfo? {
+    GC.collect()
+    return GC.lastGCInfo
+}
+
+/**
+ * Returns the allocations of each of the [operations] run since the collection [before],
+ * or `null` if another collection has swept a part of them already.
+ */
+@NativeRuntimeApi
+internal fun allocationsSince(before: GCInfo?, operations: Int): AllocationStats? {
+    val after = collectGarbage() ?: return null
+    if (before == null || after.epoch != before.epoch + 1) return null
+
+    val swept = after.sweepStatistics.values.sumOf { it.sweptCount }
+    val allocatedBytes = after.memoryUsageBefore.values.sumOf { it.totalObjectsSizeBytes } -
+        before.memoryUsageAfter.values.sumOf { it.totalObjectsSizeBytes }
+    return AllocationStats(swept.toDouble() / operations, allocatedBytes.toDouble() / operations)
+}
+
+private fun Double.format(): String = ((this * 10).roundToLong() / 10.0).toString()
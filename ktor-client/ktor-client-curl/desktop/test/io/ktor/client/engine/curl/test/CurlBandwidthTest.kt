@@ -0,0 +1,91 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.test
+
+import io.ktor.client.engine.curl.*
+import io.ktor.client.request.*
+import io.ktor.client.statement.*
+import io.ktor.client.test.base.*
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.coroutineScope
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertTrue
+import kotlin.time.Duration.Companion.seconds
+import kotlin.time.TimeSource
+
+private const val TRANSFER_SIZE = 256 * 1024
+private const val SPEED_LIMIT = 128 * 1024L
+
+class CurlBandwidthTest : ClientEngineTest<CurlClientEngineConfig>(Curl) {
+
+    @Test
+    fun testRequestReceiveSpeedLimit() = testClient {
+        test { client ->
+            val start = TimeSource.Monotonic.markNow()
+            val body = client.get("$TEST_SERVER/bytes?size=$TRANSFER_SIZE") {
+                curl { maxReceiveSpeed = SPEED_LIMIT }
+            }.bodyAsBytes()
+            val elapsed = start.elapsedNow()
+
+            assertEquals(TRANSFER_SIZE, body.size)
+            // 256 KiB at 128 KiB/s takes ~2 s, the allowance covers the initial burst of socket buffers
+            assertTrue(elapsed >= 1.seconds, "Transfer took $elapsed, the limit was not applied")
+        }
+    }
+
+    @Test
+    fun testRequestSendSpeedLimit() = testClient {
+        test { client ->
+            val payload = "x".repeat(TRANSFER_SIZE)
+            val start = TimeSource.Monotonic.markNow()
+            val response = client.post("$TEST_SERVER/echo") {
+                setBody(payload)
+                curl { maxSendSpeed = SPEED_LIMIT }
+            }.bodyAsText()
+            val elapsed = start.elapsedNow()
+
+            assertEquals(payload.length, response.length)
+            assertTrue(elapsed >= 1.seconds, "Upload took $elapsed, the limit was not applied")
+        }
+    }
+
+    @Test
+    fun testEngineTotalReceiveSpeedLimit() = testClient {
+        config {
+            engine {
+                maxTotalReceiveSpeed = SPEED_LIMIT
+            }
+        }
+
+        test { client ->
+            val start = TimeSource.Monotonic.markNow()
+            val bodies = coroutineScope {
+                List(2) {
+                    async { client.get("$TEST_SERVER/bytes?size=${TRANSFER_SIZE / 2}").bodyAsBytes() }
+                }.awaitAll()
+            }
+            val elapsed = start.elapsedNow()
+
+            bodies.forEach { assertEquals(TRANSFER_SIZE / 2, it.size) }
+            // Together the transfers move 256 KiB, so the shared 128 KiB/s budget makes them last ~2 s
+            assertTrue(elapsed >= 1.seconds, "Transfers took $elapsed, the shared limit was not applied")
+        }
+    }
+
+    @Test
+    fun testInvalidEngineSpeedLimits() {
+        val config = CurlClientEngineConfig()
+        assertFailsWith<IllegalArgumentException> { config.maxSendSpeed = 0 }
+        assertFailsWith<IllegalArgumentException> { config.maxReceiveSpeed = -1 }
+        assertFailsWith<IllegalArgumentException> { config.maxTotalSendSpeed = 0 }
+        assertFailsWith<IllegalArgumentException> { config.maxTotalReceiveSpeed = -1 }
+
+        config.maxReceiveSpeed = SPEED_LIMIT
+        config.maxReceiveSpeed = null
+    }
+}
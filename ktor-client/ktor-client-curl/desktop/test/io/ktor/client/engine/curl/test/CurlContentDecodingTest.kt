@@ -0,0 +1,117 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.test
+
+import io.ktor.client.engine.curl.*
+import io.ktor.client.request.*
+import io.ktor.client.statement.*
+import io.ktor.client.test.base.*
+import io.ktor.http.*
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.coroutineScope
+import kotlin.test.Test
+import kotlin.test.assertContentEquals
+import kotlin.test.assertEquals
+import kotlin.test.assertNull
+
+class CurlContentDecodingTest : ClientEngineTest<CurlClientEngineConfig>(Curl) {
+
+    @Test
+    fun testOffloadedGzipDecoding() = testClient {
+        config {
+            engine {
+                offloadContentDecoding = true
+            }
+        }
+
+        test { client ->
+            val response = client.get("$TEST_SERVER/compression/gzip")
+            assertEquals("Compressed response!", response.bodyAsText())
+            assertNull(response.headers[HttpHeaders.ContentEncoding])
+            assertNull(response.headers[HttpHeaders.ContentLength])
+        }
+    }
+
+    @Test
+    fun testOffloadedDeflateDecoding() = testClient {
+        test { client ->
+            val response = client.get("$TEST_SERVER/compression/deflate") {
+                curl { offloadContentDecoding = true }
+            }
+            assertEquals("Compressed response!", response.bodyAsText())
+            assertNull(response.headers[HttpHeaders.ContentEncoding])
+        }
+    }
+
+    @Test
+    fun testOffloadedDecodingOfPrecompressedBody() = testClient {
+        config {
+            engine {
+                offloadContentDecoding = true
+            }
+        }
+
+        test { client ->
+            val expected = ByteArray(500) { it.toByte() }
+            val bodies = coroutineScope {
+                List(10) {
+                    async { client.get("$TEST_SERVER/compression/gzip-precompressed").bodyAsBytes() }
+                }.awaitAll()
+            }
+            bodies.forEach { assertContentEquals(expected, it) }
+        }
+    }
+
+    @Test
+    fun testOffloadedDecodingOfEmptyBody() = testClient {
+        config {
+            engine {
+                offloadContentDecoding = true
+            }
+        }
+
+        test { client ->
+            val response = client.get("$TEST_SERVER/compression/gzip-empty")
+            assertEquals("", response.bodyAsText())
+        }
+    }
+
+    @Test
+    fun testPassThroughContentEncoding() = testClient {
+        test { client ->
+            val response = client.get("$TEST_SERVER/compression/gzip-with-content-length") {
+                header(HttpHeaders.AcceptEncoding, "gzip")
+                curl { passThroughContentEncoding = true }
+            }
+            val body = response.bodyAsBytes()
+
+            assertEquals("gzip", response.headers[HttpHeaders.ContentEncoding])
+            assertEquals(body.size.toString(), response.headers[HttpHeaders.ContentLength])
+            // gzip magic number
+            assertEquals(0x1f.toByte(), body[0])
+            assertEquals(0x8b.toByte(), body[1])
+        }
+    }
+
+    @Test
+    fun testPassThroughWinsOverOffloadedDecoding() = testClient {
+        config {
+            engine {
+                offloadContentDecoding = true
+            }
+        }
+
+        test { client ->
+            val response = client.get("$TEST_SERVER/compression/gzip") {
+                header(HttpHeaders.AcceptEncoding, "gzip")
+                curl { passThroughContentEncoding = true }
+            }
+
+            assertEquals("gzip", response.headers[HttpHeaders.ContentEncoding])
+            assertEquals(0x1f.toByte(), response.bodyAsBytes()[0])
+        }
+    }
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.test
+
+import io.ktor.client.engine.curl.*
+import io.ktor.client.plugins.*
+import io.ktor.client.request.*
+import io.ktor.client.statement.*
+import io.ktor.client.test.base.*
+import io.ktor.http.*
+import io.ktor.http.content.*
+import io.ktor.utils.io.*
+import kotlinx.coroutines.CompletableDeferred
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFails
+import kotlin.test.assertFailsWith
+import kotlin.test.assertNull
+
+private const val HTTP2_SERVER = "http://localhost:8084"
+
+class CurlDuplexStreamingTest : ClientEngineTest<CurlClientEngineConfig>(Curl) {
+
+    private fun TestClientBuilder<CurlClientEngineConfig>.configureDuplexClient() {
+        config {
+            engine { duplexStreamingEnabled = true }
+            defaultRequest { url(HTTP2_SERVER) }
+        }
+    }
+
+    @Test
+    fun testDuplexStreaming() = testClient {
+        configureDuplexClient()
+
+        test { client ->
+            val inputChannel = ByteChannel(true)
+            client.preparePost("/echo/stream") {
+                setBody(inputChannel)
+                curl { duplexStreaming = true }
+            }.execute { response ->
+                assertEquals(HttpProtocolVersion.HTTP_2_0, response.version)
+                val outputChannel = response.bodyAsChannel()
+                repeat(100) { index ->
+                    inputChannel.writeStringUtf8("client: $index\n")
+                    inputChannel.flush()
+                    assertEquals("server: client: $index", outputChannel.readLineStrict())
+                }
+                inputChannel.flushAndClose()
+                assertNull(outputChannel.readLineStrict())
+            }
+        }
+    }
+
+    @Test
+    fun testDuplexStreamingExceptionPropagates() = testClient {
+        configureDuplexClient()
+
+        test { client ->
+            val established = CompletableDeferred<Unit>()
+            val failingBody = object : OutgoingContent.WriteChannelContent() {
+                override suspend fun writeTo(channel: ByteWriteChannel) {
+                    channel.writeStringUtf8("client: 0\n")
+                    channel.flush()
+                    established.await()
+                    throw IllegalStateException("Client-side exception")
+                }
+            }
+
+            assertFails {
+                client.preparePost("/echo/stream") {
+                    setBody(failingBody)
+                    curl { duplexStreaming = true }
+                }.execute { response ->
+                    val outputChannel = response.bodyAsChannel()
+                    assertEquals("server: client: 0", outputChannel.readLineStrict())
+                    established.complete(Unit)
+                    outputChannel.readLineStrict()
+                }
+            }
+        }
+    }
+
+    @Test
+    fun testStreamedBodyWithoutOptInUsesHttp1() = testClient {
+        config {
+            engine { duplexStreamingEnabled = true }
+        }
+
+        test { client ->
+            // The test server doesn't accept HTTP/2 with prior knowledge
+            val response = client.post("$TEST_SERVER/content/echo") {
+                setBody(ChannelWriterContent(body = { writeStringUtf8("streamed") }, contentType = null))
+            }
+            assertEquals(HttpProtocolVersion.HTTP_1_1, response.version)
+            assertEquals("streamed", response.bodyAsText())
+        }
+    }
+
+    @Test
+    fun testDuplexRequestRequiresEngineOption() = testClient {
+        test { client ->
+            assertFailsWith<IllegalStateException> {
+                client.post("$HTTP2_SERVER/echo/stream") {
+                    setBody(ByteChannel(true))
+                    curl { duplexStreaming = true }
+                }
+            }
+        }
+    }
+}
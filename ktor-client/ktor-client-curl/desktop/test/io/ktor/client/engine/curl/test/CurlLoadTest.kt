@@ -0,0 +1,318 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.test
+
+import io.ktor.client.*
+import io.ktor.client.engine.cio.*
+import io.ktor.client.engine.curl.*
+import io.ktor.client.plugins.websocket.*
+import io.ktor.client.request.*
+import io.ktor.client.request.forms.*
+import io.ktor.client.statement.*
+import io.ktor.http.*
+import io.ktor.http.content.*
+import io.ktor.utils.io.*
+import io.ktor.websocket.*
+import kotlinx.cinterop.ExperimentalForeignApi
+import kotlinx.cinterop.toKString
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.coroutineScope
+import kotlinx.coroutines.joinAll
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.runBlocking
+import kotlinx.io.buffered
+import kotlinx.io.files.Path
+import kotlinx.io.files.SystemFileSystem
+import kotlinx.io.files.SystemTemporaryDirectory
+import libcurl.curl_version
+import kotlin.math.roundToLong
+import kotlin.test.Ignore
+import kotlin.test.Test
+import kotlin.time.Duration
+import kotlin.time.Duration.Companion.nanoseconds
+import kotlin.time.TimeSource
+import kotlin.time.measureTime
+
+/**
+ * Drives the Curl and CIO engines through the same [LOAD_SCENARIOS] against the local test server
+ * and the servers started by the test itself.
+ * It prints the throughput, the latency percentiles, the CPU time per operation and the resident memory of each run.
+ *
+ * Both engines run in this process one after another, so the resident memory includes the engines run before.
+ * The workers run on a single thread, as a caller of the client usually does, while each engine uses its own threads.
+ * Ignored since a run takes several minutes, run it manually on an otherwise idle machine.
+ */
+@Ignore
+class CurlLoadTest {
+
+    @OptIn(ExperimentalForeignApi::class)
+    @Test
+    fun testCompareEngines(): Unit = runBlocking {
+        println("libcurl: ${curl_version()?.toKString()}")
+        withLocalLoadServers {
+            for (scenario in LOAD_SCENARIOS) {
+                for (engine in LoadEngine.entries) {
+                    if (engine !in scenario.engines) {
+                        println("${scenario.name} [$engine]: not supported")
+                        continue
+                    }
+                    println(runScenario(scenario, engine))
+                }
+            }
+        }
+    }
+}
+
+private class LoadResult(
+    val scenario: LoadScenario,
+    val engine: LoadEngine,
+    val elapsed: Duration,
+    val bytes: Long,
+    val latencies: List<Long>,
+    val cpuTime: Duration,
+    val residentSetSize: Long?,
+    val versions: Set<HttpProtocolVersion>,
+) {
+    override fun toString(): String = buildString {
+        val operations = scenario.operations
+        val seconds = elapsed.inWholeNanoseconds / 1_000_000_000.0
+        append("${scenario.name} [$engine]: ${(operations / seconds).roundToLong()} ops/s")
+        if (bytes > 0) append(", ${(bytes / seconds / (1024 * 1024)).roundToLong()} MiB/s")
+        append(", latency p50 ${latencies.percentile(0.5).nanoseconds}")
+        append(", p99 ${latencies.percentile(0.99).nanoseconds}")
+        append(", p999 ${latencies.percentile(0.999).nanoseconds}")
+        append(", CPU ${cpuTime / operations} per operation")
+        append(", RSS ${formatBytes(residentSetSize)}")
+        if (versions.isNotEmpty()) append(", ${versions.joinToString()}")
+    }
+}
+
+private fun createClient(engine: LoadEngine, scenario: LoadScenario): HttpClient = when (engine) {
+    LoadEngine.Curl -> HttpClient(Curl) {
+        engine {
+            // The TLS server of the test server has a self-signed certificate
+            sslVerify = false
+            scenario.curl(this)
+        }
+        install(WebSockets)
+    }
+
+    LoadEngine.CIO -> HttpClient(CIO) {
+        install(WebSockets)
+    }
+}
+
+private suspend fun runScenario(scenario: LoadScenario, engine: LoadEngine): LoadResult {
+    val files = createFiles(scenario)
+    val client = createClient(engine, scenario)
+    val sessions = mutableListOf<WebSocketSession>()
+    val streams = mutableListOf<DuplexStream>()
+    try {
+        val payload = ByteArray(scenario.payloadSize)
+        val versions = mutableSetOf<HttpProtocolVersion>()
+
+        // Each operation returns the number of bytes it has transferred
+        val workers: List<suspend () -> Long> = List(scenario.concurrency) {
+            when (scenario.kind) {
+                LoadKind.Get -> suspend { client.download(scenario, versions) }
+
+                LoadKind.Upload -> suspend {
+                    client.preparePost(scenario.url) {
+                        scenario.request(this)
+                        setBody(payload)
+                    }.execute { it.bodyAsChannel().discard() }
+                    payload.size.toLong()
+                }
+
+                LoadKind.NewConnection -> suspend {
+                    val newClient = createClient(engine, scenario)
+                    try {
+                        newClient.download(scenario, versions)
+                    } finally {
+                        newClient.close()
+                    }
+                }
+
+                LoadKind.StreamedUpload -> suspend {
+                    client.preparePost(scenario.url) {
+                        scenario.request(this)
+                        setBody(StreamedBody(payload))
+                    }.execute { it.bodyAsChannel().discard() }
+                    payload.size.toLong()
+                }
+
+                LoadKind.MultipartFiles -> suspend {
+                    val form = formData {
+                        files.forEachIndexed { index, path -> appendFile("file$index", path) }
+                    }
+                    client.submitFormWithBinaryData(scenario.url, form) { scenario.request(this) }
+                    files.size * payload.size.toLong()
+                }
+
+                LoadKind.WebSocketEcho -> {
+                    val session = client.webSocketSession(scenario.url).also { sessions += it }
+                    suspend {
+                        session.send(Frame.Binary(fin = true, payload))
+                        session.incoming.receive().data.size.toLong()
+                    }
+                }
+
+                LoadKind.DuplexEcho -> {
+                    val stream = client.openDuplexStream(scenario).also { streams += it }
+                    // The echo server replies to each line, so a message is a line of the payload size
+                    val message = "m".repeat(maxOf(scenario.payloadSize - 1, 0)) + "\n"
+                    suspend {
+                        stream.requestBody.writeStringUtf8(message)
+                        stream.requestBody.flush()
+                        stream.responseBody.readLineStrict()?.length?.toLong() ?: error("The echo stream has ended")
+                    }
+                }
+            }
+        }
+
+        val latencies = LongArray(scenario.operations)
+        var bytes = 0L
+        var elapsed = Duration.ZERO
+        var cpuTime = Duration.ZERO
+        client.withBackgroundLoad(scenario) {
+            runOperations(workers, maxOf(scenario.operations / 10, 1), latencies = null)
+
+            val cpuStart = processCpuTime()
+            elapsed = measureTime { bytes = runOperations(workers, scenario.operations, latencies) }
+            cpuTime = processCpuTime() - cpuStart
+        }
+
+        return LoadResult(
+            scenario,
+            engine,
+            elapsed,
+            bytes,
+            latencies.sorted(),
+            cpuTime,
+            residentSetSize(),
+            versions,
+        )
+    } finally {
+        sessions.forEach { it.close() }
+        streams.forEach { it.close() }
+        client.close()
+        files.forEach { SystemFileSystem.delete(it, mustExist = false) }
+    }
+}
+
+private suspend fun HttpClient.download(scenario: LoadScenario, versions: MutableSet<HttpProtocolVersion>): Long =
+    prepareGet(scenario.url) { scenario.request(this) }.execute { response ->
+        versions += response.version
+        response.bodyAsChannel().discard()
+    }
+
+// Writes of an application producing the body as it goes, such as a serializer
+private const val STREAMED_WRITE_SIZE = 8 * 1024
+
+/**
+ * A body of unknown length written in parts of [STREAMED_WRITE_SIZE] bytes.
+ */
+private class StreamedBody(private val payload: ByteArray) : OutgoingContent.WriteChannelContent() {
+    override suspend fun writeTo(channel: ByteWriteChannel) {
+        for (offset in payload.indices step STREAMED_WRITE_SIZE) {
+            channel.writeFully(payload, offset, minOf(offset + STREAMED_WRITE_SIZE, payload.size))
+        }
+    }
+}
+
+/**
+ * Creates the files uploaded by the [scenario] in the temporary directory.
+ */
+private fun createFiles(scenario: LoadScenario): List<Path> {
+    val content = ByteArray(scenario.payloadSize) { it.toByte() }
+    return List(scenario.fileCount) { index ->
+        Path(SystemTemporaryDirectory, "ktor-curl-load-test-$index.bin").also { path ->
+            SystemFileSystem.sink(path).buffered().use { it.write(content) }
+        }
+    }
+}
+
+/**
+ * A request and its response streamed at the same time over one HTTP/2 stream.
+ */
+private class DuplexStream(
+    val requestBody: ByteWriteChannel,
+    val responseBody: ByteReadChannel,
+    private val done: CompletableDeferred<Unit>,
+    private val job: Job,
+) {
+    suspend fun close() {
+        requestBody.flushAndClose()
+        done.complete(Unit)
+        job.join()
+    }
+}
+
+/**
+ * Starts a duplex request of the [scenario] and returns it once the response headers arrive.
+ * The response stays open until the stream is closed.
+ */
+private suspend fun HttpClient.openDuplexStream(scenario: LoadScenario): DuplexStream {
+    val requestBody = ByteChannel()
+    val responseBody = CompletableDeferred<ByteReadChannel>()
+    val done = CompletableDeferred<Unit>()
+    val job = launch {
+        try {
+            preparePost(scenario.url) {
+                scenario.request(this)
+                setBody(requestBody)
+            }.execute { response ->
+                responseBody.complete(response.bodyAsChannel())
+                done.await()
+            }
+        } catch (cause: Throwable) {
+            responseBody.completeExceptionally(cause)
+        }
+    }
+    return DuplexStream(requestBody, responseBody.await(), done, job)
+}
+
+/**
+ * Runs the [block] while the background workers of the [scenario] download its `backgroundUrl` over and over.
+ */
+private suspend fun HttpClient.withBackgroundLoad(scenario: LoadScenario, block: suspend () -> Unit) =
+    coroutineScope {
+        val background = List(scenario.backgroundConcurrency) {
+            launch {
+                val url = checkNotNull(scenario.backgroundUrl) { "No background URL in ${scenario.name}" }
+                while (true) {
+                    prepareGet(url).execute { it.bodyAsChannel().discard() }
+                }
+            }
+        }
+        try {
+            block()
+        } finally {
+            background.forEach { it.cancel() }
+        }
+    }
+
+/**
+ * Runs [count] operations on the [workers], each worker taking the next operation once its previous one completes.
+ * Stores the latency of each operation in nanoseconds to the [latencies] and returns the number of transferred bytes.
+ */
+private suspend fun runOperations(workers: List<suspend () -> Long>, count: Int, latencies: LongArray?): Long =
+    coroutineScope {
+        // The workers run on the thread of this coroutine, so the counters need no synchronization
+        var next = 0
+        var bytes = 0L
+        workers.map { operation ->
+            launch {
+                while (next < count) {
+                    val index = next++
+                    val start = TimeSource.Monotonic.markNow()
+                    bytes += operation()
+                    latencies?.set(index, start.elapsedNow().inWholeNanoseconds)
+                }
+            }
+        }.joinAll()
+        bytes
+    }
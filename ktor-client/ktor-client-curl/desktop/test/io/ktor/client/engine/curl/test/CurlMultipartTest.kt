@@ -0,0 +1,96 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.test
+
+import io.ktor.client.*
+import io.ktor.client.engine.curl.*
+import io.ktor.client.request.forms.*
+import io.ktor.client.statement.*
+import io.ktor.http.*
+import io.ktor.http.content.*
+import io.ktor.server.request.*
+import io.ktor.server.response.*
+import io.ktor.server.routing.*
+import io.ktor.test.*
+import io.ktor.utils.io.*
+import kotlinx.io.buffered
+import kotlinx.io.files.*
+import kotlinx.io.readByteArray
+import kotlin.test.*
+import kotlin.uuid.*
+
+private const val FILE_SIZE = 256 * 1024
+
+class CurlMultipartTest {
+
+    private val fileContent = ByteArray(FILE_SIZE) { (it % 251).toByte() }
+
+    /**
+     * Responds with a line per received part: its name, file name, content type and a summary of its content.
+     */
+    private suspend fun withServer(block: suspend (client: HttpClient, url: String) -> Unit) = withEmbeddedServer(
+        routes = {
+            post("/multipart") {
+                val lines = mutableListOf<String>()
+                call.receiveMultipart(formFieldLimit = FILE_SIZE + 1L).forEachPart { part ->
+                    val content = when (part) {
+                        is PartData.FormItem -> part.value
+                        is PartData.FileItem -> {
+                            val bytes = part.provider().readRemaining().readByteArray()
+                            if (bytes.contentEquals(fileContent)) "file content" else "${bytes.size} bytes"
+                        }
+                        else -> "unexpected part"
+                    }
+                    val fileName = (part as? PartData.FileItem)?.originalFileName
+                    lines += "${part.name}|$fileName|${part.contentType}|$content"
+                    part.dispose()
+                }
+                call.respondText(lines.joinToString("\n"))
+            }
+        },
+    ) { client, url -> block(client, "$url/multipart") }
+
+    @OptIn(ExperimentalUuidApi::class)
+    @Test
+    fun testMultipartWithLocalFiles() = runTest {
+        val path = Path(SystemTemporaryDirectory, "curl-multipart-test-${Uuid.random()}.bin")
+        SystemFileSystem.sink(path).buffered().use { it.write(fileContent) }
+        try {
+            withServer { client, url ->
+                val response = client.submitFormWithBinaryData(
+                    url,
+                    formData {
+                        append("text", "Hello, World!")
+                        appendFile("first", path)
+                        append("bytes", "binary".encodeToByteArray())
+                        append("stream", ChannelProvider { ByteReadChannel("streamed") })
+                        appendFile(
+                            "second",
+                            path,
+                            Headers.build {
+                                append(HttpHeaders.ContentDisposition, "filename=\"renamed.bin\"")
+                                append(HttpHeaders.ContentType, ContentType.Application.OctetStream.toString())
+                            }
+                        )
+                    }
+                )
+
+                assertEquals(HttpStatusCode.OK, response.status)
+                assertEquals(
+                    listOf(
+                        "text|null|null|Hello, World!",
+                        "first|${path.name}|application/octet-stream|file content",
+                        "bytes|null|null|binary",
+                        "stream|null|null|streamed",
+                        "second|renamed.bin|application/octet-stream|file content",
+                    ),
+                    response.bodyAsText().lines()
+                )
+            }
+        } finally {
+            SystemFileSystem.delete(path, mustExist = false)
+        }
+    }
+}
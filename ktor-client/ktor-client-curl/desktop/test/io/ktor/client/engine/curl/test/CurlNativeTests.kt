@@ -5,11 +5,24 @@
 package io.ktor.client.engine.curl.test
 
 import io.ktor.client.engine.curl.*
+import io.ktor.client.plugins.*
 import io.ktor.client.request.*
 import io.ktor.client.statement.*
 import io.ktor.client.test.base.*
+import io.ktor.http.*
+import io.ktor.http.content.*
+import io.ktor.utils.io.*
+import kotlinx.coroutines.awaitCancellation
+import kotlinx.io.buffered
+import kotlinx.io.files.*
+import kotlinx.io.readByteArray
+import kotlinx.io.writeString
 import kotlin.test.Test
+import kotlin.test.assertContentEquals
 import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.uuid.ExperimentalUuidApi
+import kotlin.uuid.Uuid
 
 class CurlNativeTests : ClientEngineTest<CurlClientEngineConfig>(Curl) {
 
@@ -33,4 +46,133 @@ class CurlNativeTests : ClientEngineTest<CurlClientEngineConfig>(Curl) {
             assertEquals("OK 1", responseWithBody.bodyAsText())
         }
     }
+
+    @Test
+    fun testInMemoryBodyUpload() = testClient {
+        test { client ->
+            val payload = "a".repeat(1024 * 1024)
+            val response = client.post("$TEST_SERVER/echo") {
+                setBody(payload)
+            }
+            assertEquals(payload, response.bodyAsText())
+
+            val empty = client.post("$TEST_SERVER/echo") {
+                setBody(ByteArray(0))
+            }
+            assertEquals("", empty.bodyAsText())
+        }
+    }
+
+    @Test
+    fun testStreamingBodyUpload() = testClient {
+        test { client ->
+            // Larger than the flushed buffer, so the producer has to wait for libcurl to send it
+            val chunk = "c".repeat(64 * 1024)
+            val chunks = 40
+            val response = client.post("$TEST_SERVER/echo") {
+                setBody(
+                    ChannelWriterContent(
+                        body = {
+                            repeat(chunks) {
+                                writeStringUtf8(chunk)
+                                flush()
+                            }
+                        },
+                        contentType = ContentType.Text.Plain
+                    )
+                )
+            }
+            assertEquals(chunk.repeat(chunks), response.bodyAsText())
+
+            val empty = client.post("$TEST_SERVER/echo") {
+                setBody(ChannelWriterContent(body = {}, contentType = ContentType.Text.Plain))
+            }
+            assertEquals("", empty.bodyAsText())
+        }
+    }
+
+    @OptIn(ExperimentalUuidApi::class)
+    @Test
+    fun testLocalFileUpload() = testClient {
+        test { client ->
+            val payload = "b".repeat(1024 * 1024)
+            val path = Path(SystemTemporaryDirectory, "curl-upload-test-${Uuid.random()}.txt")
+            try {
+                SystemFileSystem.sink(path).buffered().use { it.writeString(payload) }
+
+                val response = client.post("$TEST_SERVER/echo") {
+                    setBody(LocalFileContent(path))
+                }
+                assertEquals(payload, response.bodyAsText())
+            } finally {
+                SystemFileSystem.delete(path, mustExist = false)
+            }
+        }
+    }
+
+    @OptIn(ExperimentalUuidApi::class)
+    @Test
+    fun testDownloadToFile() = testClient {
+        test { client ->
+            val size = 1024 * 1024
+            val path = Path(SystemTemporaryDirectory, "curl-download-test-${Uuid.random()}.bin")
+            try {
+                val downloadedFile = client.prepareGet("$TEST_SERVER/bytes?size=$size") {
+                    curl { downloadPath = path }
+                }.execute { response ->
+                    assertEquals(0, response.bodyAsBytes().size)
+                    response.downloadedFile()
+                }
+
+                assertEquals(path, downloadedFile.path)
+                assertEquals(size.toLong(), downloadedFile.size)
+                val content = SystemFileSystem.source(path).buffered().use { it.readByteArray() }
+                assertContentEquals(ByteArray(size) { it.toByte() }, content)
+            } finally {
+                SystemFileSystem.delete(path, mustExist = false)
+            }
+        }
+    }
+
+    @OptIn(ExperimentalUuidApi::class)
+    @Test
+    fun testErrorResponseIsNotDownloadedToFile() = testClient {
+        test { client ->
+            val path = Path(SystemTemporaryDirectory, "curl-download-test-${Uuid.random()}.bin")
+            try {
+                SystemFileSystem.sink(path).buffered().use { it.writeString("existing content") }
+
+                val failure = client.prepareGet("$TEST_SERVER/download-to-file/missing") {
+                    curl { downloadPath = path }
+                }.execute { response ->
+                    assertFailsWith<ResponseException> { response.downloadedFile() }
+                }
+
+                assertEquals(HttpStatusCode.NotFound, failure.response.status)
+                val content = SystemFileSystem.source(path).buffered().use { it.readByteArray() }
+                assertEquals("existing content", content.decodeToString())
+            } finally {
+                SystemFileSystem.delete(path, mustExist = false)
+            }
+        }
+    }
+
+    @Test
+    fun testRequestTimeoutDuringTlsHandshake() = testClient {
+        config {
+            install(HttpTimeout) {
+                requestTimeoutMillis = 500
+                connectTimeoutMillis = 10_000
+            }
+        }
+
+        test { client ->
+            // The server accepts the connection but never answers the TLS handshake, so no request bytes are sent
+            withTcpServer(handler = { _, _ -> awaitCancellation() }) { port ->
+                assertFailsWith<HttpRequestTimeoutException> {
+                    client.get("https://127.0.0.1:$port/")
+                }
+            }
+        }
+    }
 }
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.test
+
+import io.ktor.client.*
+import io.ktor.client.engine.curl.*
+import io.ktor.client.request.*
+import io.ktor.client.statement.*
+import io.ktor.http.*
+import io.ktor.server.application.*
+import io.ktor.server.response.*
+import io.ktor.server.routing.*
+import io.ktor.test.*
+import io.ktor.utils.io.*
+import kotlinx.atomicfu.atomic
+import kotlinx.io.IOException
+import kotlin.test.*
+
+private const val CONTENT_SIZE = 256 * 1024
+private const val ETAG = "\"v1\""
+
+class CurlResumableDownloadTest {
+
+    private val content = ByteArray(CONTENT_SIZE) { (it % 251).toByte() }
+    private val resumeRequests = atomic(0)
+
+    /**
+     * Responds with the first half of the content tagged with [etag] and breaks the connection,
+     * then serves the rest to a range request with `If-Range` matching the current [ETAG].
+     */
+    private suspend fun ApplicationCall.respondFlaky(etag: String?) {
+        val range = request.headers[HttpHeaders.Range]
+        if (range == null) {
+            etag?.let { response.header(HttpHeaders.ETag, it) }
+            respondBytesWriter(status = HttpStatusCode.OK, contentLength = CONTENT_SIZE.toLong()) {
+                writeFully(content, 0, CONTENT_SIZE / 2)
+                flush()
+                throw IOException("Connection broken")
+            }
+            return
+        }
+
+        resumeRequests.incrementAndGet()
+        if (request.headers[HttpHeaders.IfRange] != ETAG) {
+            respondBytes(content)
+            return
+        }
+        val start = range.removePrefix("bytes=").substringBefore('-').toInt()
+        response.header(HttpHeaders.ContentRange, "bytes $start-${CONTENT_SIZE - 1}/$CONTENT_SIZE")
+        respondBytesWriter(status = HttpStatusCode.PartialContent, contentLength = (CONTENT_SIZE - start).toLong()) {
+            writeFully(content, start, CONTENT_SIZE - start)
+        }
+    }
+
+    private suspend fun withServer(block: suspend (client: HttpClient, url: String) -> Unit) = withEmbeddedServer(
+        routes = {
+            get("/flaky") { call.respondFlaky(etag = ETAG) }
+            get("/flaky-without-validator") { call.respondFlaky(etag = null) }
+            // The resource changes to ETAG before the rest of the body is requested
+            get("/flaky-changed") { call.respondFlaky(etag = "\"v0\"") }
+        },
+        clientConfig = {
+            engine {
+                maxResumeAttempts = 2
+            }
+        },
+        block = block,
+    )
+
+    @Test
+    fun testInterruptedBodyIsResumed() = runTest {
+        withServer { client, url ->
+            val response = client.get("$url/flaky")
+
+            assertEquals(HttpStatusCode.OK, response.status)
+            assertContentEquals(content, response.bodyAsBytes())
+            assertEquals(1, resumeRequests.value)
+        }
+    }
+
+    @Test
+    fun testInterruptedBodyWithoutValidatorFails() = runTest {
+        withServer { client, url ->
+            assertFails {
+                client.get("$url/flaky-without-validator").bodyAsBytes()
+            }
+            assertEquals(0, resumeRequests.value)
+        }
+    }
+
+    @Test
+    fun testInterruptedBodyOfChangedResourceFails() = runTest {
+        withServer { client, url ->
+            // The server answers the stale If-Range with the whole new resource, which can't continue the body
+            assertFails {
+                client.get("$url/flaky-changed").bodyAsBytes()
+            }
+            assertEquals(1, resumeRequests.value)
+        }
+    }
+
+    @Test
+    fun testResumeDisabledForRequest() = runTest {
+        withServer { client, url ->
+            assertFails {
+                client.get("$url/flaky") {
+                    curl { maxResumeAttempts = 0 }
+                }.bodyAsBytes()
+            }
+            assertEquals(0, resumeRequests.value)
+        }
+    }
+}
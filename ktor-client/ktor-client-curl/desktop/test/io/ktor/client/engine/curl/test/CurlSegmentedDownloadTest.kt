@@ -0,0 +1,161 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.test
+
+import io.ktor.client.*
+import io.ktor.client.engine.curl.*
+import io.ktor.http.*
+import io.ktor.http.content.*
+import io.ktor.server.application.*
+import io.ktor.server.plugins.partialcontent.*
+import io.ktor.server.response.*
+import io.ktor.server.routing.*
+import io.ktor.test.*
+import io.ktor.utils.io.*
+import kotlinx.atomicfu.atomic
+import kotlinx.io.buffered
+import kotlinx.io.files.*
+import kotlinx.io.readByteArray
+import kotlin.test.*
+import kotlin.uuid.*
+
+private const val CONTENT_SIZE = 1024 * 1024 + 123
+private const val SEGMENT_SIZE = 64 * 1024L
+
+class CurlSegmentedDownloadTest {
+
+    private val content = ByteArray(CONTENT_SIZE) { (it % 251).toByte() }
+    private val rangeRequests = atomic(0)
+    private val encodedRequests = atomic(0)
+    private val missingRequests = atomic(0)
+
+    private class RangeContent(private val bytes: ByteArray) : OutgoingContent.ReadChannelContent() {
+        override val contentLength: Long = bytes.size.toLong()
+        override val contentType: ContentType = ContentType.Application.OctetStream
+
+        override fun readFrom(): ByteReadChannel = ByteReadChannel(bytes)
+
+        override fun readFrom(range: LongRange): ByteReadChannel =
+            ByteReadChannel(bytes, range.first.toInt(), (range.last - range.first + 1).toInt())
+    }
+
+    @OptIn(ExperimentalUuidApi::class)
+    private suspend fun withServerAndFile(block: suspend (client: HttpClient, url: String, path: Path) -> Unit) {
+        val path = Path(SystemTemporaryDirectory, "curl-segmented-test-${Uuid.random()}.bin")
+        try {
+            withEmbeddedServer(routes = {
+                install(PartialContent)
+                get("/ranges") {
+                    if (call.request.headers.contains(HttpHeaders.Range)) rangeRequests.incrementAndGet()
+                    val acceptEncoding = call.request.headers[HttpHeaders.AcceptEncoding]
+                    if (acceptEncoding != "identity") encodedRequests.incrementAndGet()
+                    call.respond(RangeContent(content))
+                }
+                get("/unknown-size") {
+                    if (call.request.headers.contains(HttpHeaders.Range)) {
+                        val last = SEGMENT_SIZE - 1
+                        call.response.header(HttpHeaders.ContentRange, "bytes 0-$last/*")
+                        call.respondBytes(content.copyOf(SEGMENT_SIZE.toInt()), status = HttpStatusCode.PartialContent)
+                    } else {
+                        call.respondBytes(content)
+                    }
+                }
+                get("/missing") {
+                    missingRequests.incrementAndGet()
+                    call.respondText("Not here", status = HttpStatusCode.NotFound)
+                }
+                get("/no-ranges") {
+                    // PartialContent doesn't handle byte array responses
+                    call.respondBytes(content)
+                }
+            }) { client, url ->
+                block(client, url, path)
+            }
+        } finally {
+            SystemFileSystem.delete(path, mustExist = false)
+        }
+    }
+
+    private fun readFile(path: Path): ByteArray =
+        SystemFileSystem.source(path).buffered().use { it.readByteArray() }
+
+    @Test
+    fun testSegmentedDownload() = runTest {
+        withServerAndFile { client, url, path ->
+            val file = client.downloadSegmented("$url/ranges", path) {
+                segmentSize = SEGMENT_SIZE
+                maxParallelism = 4
+            }
+
+            assertEquals(CONTENT_SIZE.toLong(), file.size)
+            assertContentEquals(content, readFile(path))
+            val expectedSegments = (CONTENT_SIZE + SEGMENT_SIZE - 1) / SEGMENT_SIZE
+            assertEquals(expectedSegments.toInt(), rangeRequests.value)
+        }
+    }
+
+    @Test
+    fun testServerWithoutRangeSupport() = runTest {
+        withServerAndFile { client, url, path ->
+            val file = client.downloadSegmented("$url/no-ranges", path) {
+                segmentSize = SEGMENT_SIZE
+            }
+
+            assertEquals(CONTENT_SIZE.toLong(), file.size)
+            assertContentEquals(content, readFile(path))
+        }
+    }
+
+    @Test
+    fun testServerWithoutTotalSize() = runTest {
+        withServerAndFile { client, url, path ->
+            val file = client.downloadSegmented("$url/unknown-size", path) {
+                segmentSize = SEGMENT_SIZE
+            }
+
+            assertEquals(CONTENT_SIZE.toLong(), file.size)
+            assertContentEquals(content, readFile(path))
+        }
+    }
+
+    @Test
+    fun testSegmentsAreNotEncoded() = runTest {
+        withServerAndFile { client, url, path ->
+            client.downloadSegmented("$url/ranges", path) {
+                segmentSize = SEGMENT_SIZE
+            }
+
+            assertEquals(0, encodedRequests.value)
+        }
+    }
+
+    @Test
+    fun testErrorBodyIsNotWritten() = runTest {
+        withServerAndFile { client, url, path ->
+            val existing = "existing content".encodeToByteArray()
+            SystemFileSystem.sink(path).buffered().use { it.write(existing) }
+
+            assertFailsWith<IllegalStateException> {
+                client.downloadSegmented("$url/missing", path) {
+                    segmentSize = SEGMENT_SIZE
+                }
+            }
+            assertContentEquals(existing, readFile(path))
+        }
+    }
+
+    @Test
+    fun testErrorResponseIsNotRetried() = runTest {
+        withServerAndFile { client, url, path ->
+            assertFailsWith<IllegalStateException> {
+                client.downloadSegmented("$url/missing", path) {
+                    segmentSize = SEGMENT_SIZE
+                    maxRetries = 3
+                }
+            }
+            assertEquals(1, missingRequests.value)
+        }
+    }
+}
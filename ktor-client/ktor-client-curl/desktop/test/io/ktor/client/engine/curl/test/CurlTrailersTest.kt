@@ -0,0 +1,109 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.test
+
+import io.ktor.client.*
+import io.ktor.client.engine.curl.*
+import io.ktor.client.request.*
+import io.ktor.client.statement.*
+import io.ktor.client.test.base.*
+import io.ktor.http.*
+import io.ktor.http.content.*
+import io.ktor.test.*
+import io.ktor.utils.io.*
+import kotlinx.coroutines.CompletableDeferred
+import kotlin.test.*
+
+class CurlTrailersTest {
+
+    /**
+     * Returns the raw request lines starting with the body and responds with a chunked body followed by a trailer.
+     */
+    private suspend fun exchangeWithTrailers(input: ByteReadChannel, output: ByteWriteChannel): List<String> {
+        while (input.readUTF8Line()?.isNotEmpty() == true) {
+            // skip the request headers
+        }
+        val body = mutableListOf<String>()
+        var lastChunk = false
+        while (true) {
+            val line = input.readUTF8Line() ?: break
+            if (lastChunk && line.isEmpty()) break
+            if (line == "0") lastChunk = true
+            body += line
+        }
+
+        output.writeStringUtf8(
+            "HTTP/1.1 200 OK\r\n" +
+                "Transfer-Encoding: chunked\r\n" +
+                "Trailer: X-Checksum\r\n" +
+                "Connection: close\r\n\r\n" +
+                "5\r\nhello\r\n" +
+                "0\r\nX-Checksum: 42\r\n\r\n"
+        )
+        output.flushAndClose()
+        return body
+    }
+
+    @Test
+    fun testRequestAndResponseTrailers() = runTest {
+        val requestLines = CompletableDeferred<List<String>>()
+        withTcpServer({ input, output -> requestLines.complete(exchangeWithTrailers(input, output)) }) { port ->
+            HttpClient(Curl).use { client ->
+                var written = 0
+                client.preparePost("http://127.0.0.1:$port/upload") {
+                    header(HttpHeaders.Trailer, "X-Written")
+                    setBody(
+                        ChannelWriterContent(
+                            body = { writeStringUtf8("body"); written += 4 },
+                            contentType = ContentType.Text.Plain
+                        )
+                    )
+                    curl { requestTrailers = { headersOf("X-Written", written.toString()) } }
+                }.execute { response ->
+                    assertEquals("hello", response.bodyAsText())
+                    assertEquals("42", response.trailers()["X-Checksum"])
+                }
+
+                val lines = requestLines.await()
+                assertContains(lines, "body")
+                assertContains(lines, "X-Written: 4")
+            }
+        }
+    }
+
+    @Test
+    fun testRequestTrailersAreSentOverHttp11() = runTest {
+        HttpClient(Curl) { engine { sslVerify = false } }.use { client ->
+            // The TLS test server negotiates HTTP/2, over which libcurl doesn't send request trailers
+            val response = client.put("https://localhost:8089/") {
+                setBody(ChannelWriterContent(body = { writeStringUtf8("body") }, contentType = ContentType.Text.Plain))
+                curl { requestTrailers = { headersOf("X-Written", "4") } }
+            }
+            assertEquals(HttpProtocolVersion.HTTP_1_1, response.version)
+        }
+    }
+
+    @Test
+    fun testRequestTrailersRequireWriteChannelContent() = runTest {
+        HttpClient(Curl).use { client ->
+            assertFailsWith<IllegalStateException> {
+                client.post("$TEST_SERVER/content/echo") {
+                    setBody("body")
+                    curl { requestTrailers = { headersOf("X-Written", "4") } }
+                }
+            }
+        }
+    }
+
+    @Test
+    fun testNoResponseTrailers() = runTest {
+        HttpClient(Curl).use { client ->
+            client.prepareGet("$TEST_SERVER/content/hello").execute { response ->
+                assertEquals("hello", response.bodyAsText())
+                assertTrue(response.trailers().isEmpty())
+            }
+        }
+    }
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.test
+
+import io.ktor.client.*
+import io.ktor.client.engine.curl.*
+import io.ktor.client.request.*
+import io.ktor.client.statement.*
+import io.ktor.network.sockets.*
+import io.ktor.server.cio.*
+import io.ktor.server.request.*
+import io.ktor.server.response.*
+import io.ktor.server.routing.*
+import io.ktor.test.*
+import kotlinx.io.files.*
+import kotlin.test.*
+import kotlin.uuid.*
+
+class CurlUnixSocketTest {
+
+    @OptIn(ExperimentalUuidApi::class)
+    private fun createTempFilePath(basename: String): String {
+        return Path(SystemTemporaryDirectory, "$basename-${Uuid.random()}").toString()
+    }
+
+    private inline fun withTempFile(block: (String) -> Unit) {
+        val path = createTempFilePath("curl-unix-socket-test")
+        try {
+            block(path)
+        } finally {
+            SystemFileSystem.delete(Path(path), mustExist = false)
+        }
+    }
+
+    private suspend fun withUnixServer(
+        socketPath: String,
+        clientConfig: HttpClientConfig<CurlClientEngineConfig>.() -> Unit = {},
+        block: suspend (client: HttpClient) -> Unit,
+    ) = withEmbeddedServer(
+        routes = {
+            get("/") {
+                call.respondText("Hello, Unix socket world!")
+            }
+            post("/echo") {
+                call.respondText(call.receiveText())
+            }
+        },
+        clientConfig = clientConfig,
+        connectors = { unixConnector(socketPath) },
+    ) { client, _ -> block(client) }
+
+    @Test
+    fun testRequestUnixSocket() = runTest {
+        if (!UnixSocketAddress.isSupported()) return@runTest
+
+        withTempFile { socketPath ->
+            withUnixServer(socketPath) { client ->
+                val response = client.get("http://localhost/") {
+                    unixSocket(socketPath)
+                }
+                assertEquals(200, response.status.value)
+                assertEquals("Hello, Unix socket world!", response.bodyAsText())
+            }
+        }
+    }
+
+    @Test
+    fun testEngineUnixSocket() = runTest {
+        if (!UnixSocketAddress.isSupported()) return@runTest
+
+        withTempFile { socketPath ->
+            withUnixServer(socketPath, clientConfig = { engine { unixSocketPath = socketPath } }) { client ->
+                repeat(10) { index ->
+                    val response = client.post("http://localhost/echo") {
+                        setBody("message $index")
+                    }
+                    assertEquals("message $index", response.bodyAsText())
+                }
+            }
+        }
+    }
+}
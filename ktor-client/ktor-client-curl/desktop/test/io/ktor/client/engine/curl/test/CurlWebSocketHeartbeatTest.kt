@@ -0,0 +1,95 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.test
+
+import io.ktor.client.engine.curl.*
+import io.ktor.client.network.sockets.*
+import io.ktor.client.plugins.websocket.*
+import io.ktor.client.test.base.*
+import io.ktor.websocket.*
+import kotlinx.coroutines.awaitCancellation
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.withTimeout
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertIs
+import kotlin.test.assertNotNull
+
+class CurlWebSocketHeartbeatTest : ClientEngineTest<CurlClientEngineConfig>(Curl) {
+
+    @Test
+    fun testIdleSessionIsPinged() = testClient {
+        config {
+            engine {
+                webSocketPingIntervalMillis = 100
+            }
+            install(WebSockets)
+        }
+
+        test { client ->
+            withWebSocketServer(
+                handler = { session ->
+                    var pings = 0
+                    for (frame in session.incoming) {
+                        if (frame !is Frame.Ping) continue
+                        session.outgoing.send(Frame.Pong(frame.data))
+                        if (++pings == 3) break
+                    }
+                    session.outgoing.send(Frame.Text("pinged $pings times"))
+                }
+            ) { url ->
+                client.webSocket(url) {
+                    // Nothing is sent by the client, only the heartbeat keeps the session alive
+                    val frame = incoming.receive() as Frame.Text
+                    assertEquals("pinged 3 times", frame.readText())
+                }
+            }
+        }
+    }
+
+    @Test
+    fun testUnresponsiveServerIsDetected() = testClient {
+        config {
+            engine {
+                webSocketPingIntervalMillis = 100
+                webSocketPingTimeoutMillis = 200
+            }
+            install(WebSockets)
+        }
+
+        test { client ->
+            withWebSocketServer(handler = { awaitCancellation() }) { url ->
+                var failure: Throwable? = null
+                withTimeout(10_000) {
+                    client.webSocket(url) {
+                        // The server never replies, so the session is closed instead of waiting forever
+                        failure = incoming.receiveCatching().exceptionOrNull()
+                    }
+                }
+                assertIs<SocketTimeoutException>(assertNotNull(failure, "The unresponsive server wasn't detected"))
+            }
+        }
+    }
+
+    @Test
+    fun testPingsReachSessionWithoutAutoPong() = testClient {
+        config {
+            engine {
+                webSocketAutoPong = false
+            }
+            install(WebSockets)
+        }
+
+        test { client ->
+            client.webSocket("$TEST_WEBSOCKET_SERVER/websockets/count-pong") {
+                delay(100)
+                send("count pong")
+                // The session replies to the Ping instead of libcurl, so there is exactly one Pong
+                val countOfPongFrame = incoming.receive() as Frame.Text
+                assertEquals("1", countOfPongFrame.readText())
+            }
+        }
+    }
+}
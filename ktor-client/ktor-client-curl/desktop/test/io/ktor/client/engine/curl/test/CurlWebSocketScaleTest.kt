@@ -0,0 +1,128 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.test
+
+import io.ktor.client.engine.curl.*
+import io.ktor.client.plugins.websocket.*
+import io.ktor.client.test.base.*
+import io.ktor.websocket.*
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.channels.Channel
+import kotlinx.coroutines.coroutineScope
+import kotlinx.coroutines.delay
+import kotlin.test.Ignore
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.time.Duration
+import kotlin.time.Duration.Companion.minutes
+import kotlin.time.Duration.Companion.seconds
+import kotlin.time.TimeSource
+import kotlin.time.measureTime
+
+// Each session takes a socket on both sides, so more sessions need a higher limit of open files (`ulimit -n`)
+private const val SESSION_COUNT = 1000
+private const val ACTIVE_ROUNDS = 20
+private val IDLE_PERIOD = 5.seconds
+
+/**
+ * Measures how the engine copes with many concurrent WebSocket sessions:
+ * the memory taken by each open session, the CPU time spent while all of them are idle,
+ * the latency of a message sent to all the sessions at once and the CPU time per echoed message.
+ *
+ * The CPU time is the one of the whole process, not only of the curl thread, and the server runs in the same process,
+ * so the memory and CPU numbers include its side of the connections.
+ * They are meant to be compared between changes of the engine rather than taken as absolute values.
+ * Ignored since it takes a while and may need a higher limit of open files, run it manually.
+ */
+@Ignore
+class CurlWebSocketScaleTest : ClientEngineTest<CurlClientEngineConfig>(Curl, timeout = 10.minutes) {
+
+    @Test
+    fun testManySessions() = testClient {
+        config {
+            install(WebSockets)
+        }
+
+        test { client ->
+            val serverSessions = Channel<WebSocketSession>(Channel.UNLIMITED)
+            withWebSocketServer(
+                handler = { session ->
+                    serverSessions.send(session)
+                    for (frame in session.incoming) {
+                        session.outgoing.send(frame)
+                        if (frame is Frame.Close) break
+                    }
+                }
+            ) { url ->
+                // The first session loads the engine and the server, which is not a cost of each session
+                client.webSocketSession(url).close()
+                serverSessions.receive()
+
+                val rssBefore = residentSetSize()
+                val sessions = List(SESSION_COUNT) { client.webSocketSession(url) }
+                val servers = List(SESSION_COUNT) { serverSessions.receive() }
+                val rssAfter = residentSetSize()
+
+                val idleCpu = measureProcessCpuTime { delay(IDLE_PERIOD) }
+
+                val fanOutLatencies = coroutineScope {
+                    val start = TimeSource.Monotonic.markNow()
+                    val received = sessions.map { session ->
+                        async {
+                            assertEquals("fan-out", (session.incoming.receive() as Frame.Text).readText())
+                            start.elapsedNow()
+                        }
+                    }
+                    servers.forEach { it.outgoing.send(Frame.Text("fan-out")) }
+                    received.awaitAll().sorted()
+                }
+
+                var activeTime = Duration.ZERO
+                val activeCpu = measureProcessCpuTime {
+                    activeTime = measureTime {
+                        coroutineScope {
+                            sessions.map { session -> async { echoRounds(session) } }.awaitAll()
+                        }
+                    }
+                }
+
+                sessions.forEach { it.close() }
+
+                println(ScaleResult(rssBefore, rssAfter, idleCpu, fanOutLatencies, activeTime, activeCpu))
+            }
+        }
+    }
+}
+
+private class ScaleResult(
+    val rssBefore: Long?,
+    val rssAfter: Long?,
+    val idleProcessCpu: Duration,
+    val fanOutLatencies: List<Duration>,
+    val activeTime: Duration,
+    val activeProcessCpu: Duration,
+) {
+    override fun toString(): String = buildString {
+        val rssPerSession = if (rssBefore != null && rssAfter != null) (rssAfter - rssBefore) / SESSION_COUNT else null
+        val messages = SESSION_COUNT * ACTIVE_ROUNDS
+        append("$SESSION_COUNT WebSocket sessions: ${formatBytes(rssPerSession)} per session")
+        append(", RSS ${formatBytes(rssAfter)}")
+        append(", process CPU $idleProcessCpu while idle for $IDLE_PERIOD")
+        append(", fan-out latency p50 ${fanOutLatencies.percentile(0.5)}")
+        append(", p99 ${fanOutLatencies.percentile(0.99)}")
+        append(", max ${fanOutLatencies.last()}")
+        append(", $messages echoed messages in $activeTime")
+        append(", process CPU ${activeProcessCpu / messages} per message")
+    }
+}
+
+private suspend fun echoRounds(session: WebSocketSession) {
+    repeat(ACTIVE_ROUNDS) { round ->
+        session.send("message $round")
+        val echo = session.incoming.receive() as Frame.Text
+        assertEquals("message $round", echo.readText())
+    }
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.test
+
+import io.ktor.client.*
+import io.ktor.client.engine.curl.*
+import io.ktor.client.plugins.websocket.*
+import io.ktor.client.test.base.*
+import io.ktor.test.*
+import io.ktor.utils.io.*
+import io.ktor.websocket.*
+import kotlinx.atomicfu.AtomicLong
+import kotlinx.atomicfu.atomic
+import kotlinx.coroutines.launch
+import kotlinx.io.EOFException
+import kotlinx.io.readByteArray
+import kotlinx.io.readText
+import kotlin.test.*
+
+private const val FRAME_SIZE = 128L * 1024 * 1024
+
+// The queue, the socket buffers and the channels on both sides, but far less than the frame
+private const val MAX_BYTES_IN_FLIGHT = 32L * 1024 * 1024
+
+class CurlWebSocketStreamingTest {
+
+    /**
+     * Discards the payload of the first frame counting it in [received],
+     * replies with its length and completes the closing handshake.
+     */
+    private suspend fun receiveStreamedFrame(input: ByteReadChannel, output: ByteWriteChannel, received: AtomicLong) {
+        val length = input.discardFrame(received)
+        val reply = length.toString().encodeToByteArray()
+        output.writeByte(0x81.toByte())
+        output.writeByte(reply.size.toByte())
+        output.writeFully(reply)
+        output.flush()
+
+        // The Close frame of the client
+        input.discardFrame(atomic(0L))
+        output.writeByte(0x88.toByte())
+        output.writeByte(0)
+        output.flushAndClose()
+    }
+
+    /**
+     * Discards a masked client frame and returns the length of its payload.
+     */
+    private suspend fun ByteReadChannel.discardFrame(received: AtomicLong): Long {
+        readByte()
+        val length = when (val shortLength = readByte().toInt() and 0x7f) {
+            126 -> readShort().toLong() and 0xffff
+            127 -> readLong()
+            else -> shortLength.toLong()
+        }
+        discardExact(4) // mask
+        var remaining = length
+        while (remaining > 0) {
+            val discarded = discard(minOf(remaining, 64 * 1024L))
+            if (discarded == 0L) throw EOFException("Frame ended after ${length - remaining} of $length bytes")
+            remaining -= discarded
+            received.addAndGet(discarded)
+        }
+        return length
+    }
+
+    @Test
+    fun testStreamedFrameInBoundedMemory() = runTest {
+        val received = atomic(0L)
+        val produced = atomic(0L)
+        var maxBytesInFlight = 0L
+
+        HttpClient(Curl) { install(WebSockets) }.use { client ->
+            withRawWebSocketServer({ input, output -> receiveStreamedFrame(input, output, received) }) { url ->
+                client.webSocket(url) {
+                    val content = ByteChannel()
+                    launch {
+                        val chunk = ByteArray(64 * 1024)
+                        while (produced.value < FRAME_SIZE) {
+                            content.writeFully(chunk)
+                            content.flush()
+                            val bytesInFlight = produced.addAndGet(chunk.size.toLong()) - received.value
+                            maxBytesInFlight = maxOf(maxBytesInFlight, bytesInFlight)
+                        }
+                        content.flushAndClose()
+                    }
+
+                    sendFrame(FrameType.BINARY, content, FRAME_SIZE)
+                    val reply = incoming.receive() as Frame.Text
+                    assertEquals(FRAME_SIZE.toString(), reply.readText())
+                }
+            }
+        }
+
+        assertEquals(FRAME_SIZE, received.value)
+        assertTrue(maxBytesInFlight < MAX_BYTES_IN_FLIGHT, "Too many bytes in flight: $maxBytesInFlight")
+    }
+
+    @Test
+    fun testStreamedFrameEcho() = runTest {
+        HttpClient(Curl) { install(WebSockets) }.use { client ->
+            // The test server doesn't accept frames of this size
+            withEchoWebSocketServer { url ->
+                client.webSocket(url) {
+                    val text = "streamed ".repeat(10_000)
+                    sendFrame(FrameType.TEXT, ByteReadChannel(text), text.length.toLong())
+                    outgoing.send(Frame.Text("regular"))
+
+                    assertEquals(text, (incoming.receive() as Frame.Text).readText())
+                    assertEquals("regular", (incoming.receive() as Frame.Text).readText())
+                }
+            }
+        }
+    }
+
+    /**
+     * Sends a binary frame of [length] bytes, counting them in [sent].
+     */
+    private suspend fun sendLargeFrame(
+        input: ByteReadChannel,
+        output: ByteWriteChannel,
+        length: Long,
+        sent: AtomicLong,
+    ) {
+        output.writeByte(0x82.toByte())
+        output.writeByte(127)
+        output.writeLong(length)
+        val chunk = ByteArray(64 * 1024)
+        while (sent.value < length) {
+            output.writeFully(chunk)
+            output.flush()
+            sent.addAndGet(chunk.size.toLong())
+        }
+
+        // The Close frame of the client
+        input.discardFrame(atomic(0L))
+        output.writeByte(0x88.toByte())
+        output.writeByte(0)
+        output.flushAndClose()
+    }
+
+    @Test
+    fun testStreamedMessageInBoundedMemory() = runTest {
+        val sent = atomic(0L)
+        var received = 0L
+        var maxBytesInFlight = 0L
+
+        HttpClient(Curl) { install(WebSockets) }.use { client ->
+            withRawWebSocketServer({ input, output -> sendLargeFrame(input, output, FRAME_SIZE, sent) }) { url ->
+                client.webSocket(url, request = { curl { streamWebSocketMessages = true } }) {
+                    val message = incomingMessages.receive()
+                    assertEquals(FrameType.BINARY, message.frameType)
+                    while (true) {
+                        val discarded = message.content.discard(64 * 1024L)
+                        if (discarded == 0L) break
+                        received += discarded
+                        maxBytesInFlight = maxOf(maxBytesInFlight, sent.value - received)
+                    }
+                }
+            }
+        }
+
+        assertEquals(FRAME_SIZE, received)
+        assertTrue(maxBytesInFlight < MAX_BYTES_IN_FLIGHT, "Too many bytes in flight: $maxBytesInFlight")
+    }
+
+    @Test
+    fun testStreamedMessageEcho() = runTest {
+        HttpClient(Curl) { install(WebSockets) }.use { client ->
+            // The test server doesn't accept frames of this size
+            withEchoWebSocketServer { url ->
+                client.webSocket(url, request = { curl { streamWebSocketMessages = true } }) {
+                    val payload = ByteArray(8 * 1024 * 1024) { (it % 251).toByte() }
+                    outgoing.send(Frame.Binary(fin = true, payload))
+                    outgoing.send(Frame.Text("regular"))
+
+                    val binary = incomingMessages.receive()
+                    assertEquals(FrameType.BINARY, binary.frameType)
+                    assertContentEquals(payload, binary.content.readRemaining().readByteArray())
+
+                    val text = incomingMessages.receive()
+                    assertEquals(FrameType.TEXT, text.frameType)
+                    assertEquals("regular", text.content.readRemaining().readText())
+                }
+            }
+        }
+    }
+
+    /**
+     * Sends a text message in two fragments followed by a binary message.
+     */
+    private suspend fun sendFragments(input: ByteReadChannel, output: ByteWriteChannel) {
+        // Text without FIN, then a final continuation frame
+        output.writeFully(byteArrayOf(0x01, 7) + "Hello, ".encodeToByteArray())
+        output.writeFully(byteArrayOf(0x80.toByte(), 5) + "world".encodeToByteArray())
+        output.writeFully(byteArrayOf(0x82.toByte(), 3, 1, 2, 3))
+        output.flush()
+
+        // The Close frame of the client
+        input.discardFrame(atomic(0L))
+        output.writeByte(0x88.toByte())
+        output.writeByte(0)
+        output.flushAndClose()
+    }
+
+    @Test
+    fun testFragmentsMakeSingleMessage() = runTest {
+        HttpClient(Curl) { install(WebSockets) }.use { client ->
+            withRawWebSocketServer({ input, output -> sendFragments(input, output) }) { url ->
+                client.webSocket(url, request = { curl { streamWebSocketMessages = true } }) {
+                    val text = incomingMessages.receive()
+                    assertEquals(FrameType.TEXT, text.frameType)
+                    assertEquals("Hello, world", text.content.readRemaining().readText())
+
+                    val binary = incomingMessages.receive()
+                    assertContentEquals(byteArrayOf(1, 2, 3), binary.content.readRemaining().readByteArray())
+                }
+            }
+        }
+    }
+
+    @Test
+    fun testContentEndsEarly() = runTest {
+        HttpClient(Curl) { install(WebSockets) }.use { client ->
+            // The session is closed, as the server still waits for the rest of the frame
+            assertFailsWith<EOFException> {
+                client.webSocket("$TEST_WEBSOCKET_SERVER/websockets/echo") {
+                    sendFrame(FrameType.BINARY, ByteReadChannel("short"), length = 100)
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.test
+
+import io.ktor.client.engine.curl.*
+import io.ktor.client.plugins.websocket.*
+import io.ktor.client.test.base.*
+import io.ktor.websocket.*
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.selects.select
+import kotlin.random.Random
+import kotlin.test.Test
+import kotlin.test.assertContentEquals
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+class CurlWebSocketTest : ClientEngineTest<CurlClientEngineConfig>(Curl) {
+
+    @Test
+    fun testManySmallFrames() = testClient {
+        config { install(WebSockets) }
+
+        test { client ->
+            val count = 10_000
+            client.webSocket("$TEST_WEBSOCKET_SERVER/websockets/echo") {
+                // Frames are sent without waiting for the echo, so many of them are queued at once
+                launch {
+                    repeat(count) { outgoing.send(Frame.Text("message $it")) }
+                }
+                repeat(count) {
+                    val frame = incoming.receive() as Frame.Text
+                    assertEquals("message $it", frame.readText())
+                }
+            }
+        }
+    }
+
+    @Test
+    fun testSelectOnSend() = testClient {
+        config { install(WebSockets) }
+
+        test { client ->
+            client.webSocket("$TEST_WEBSOCKET_SERVER/websockets/echo") {
+                outgoing.send(Frame.Text("before"))
+                repeat(3) { index ->
+                    select { outgoing.onSend(Frame.Text("selected $index")) {} }
+                }
+                outgoing.send(Frame.Text("after"))
+
+                val expected = listOf("before", "selected 0", "selected 1", "selected 2", "after")
+                assertEquals(expected, List(expected.size) { (incoming.receive() as Frame.Text).readText() })
+            }
+        }
+    }
+
+    @Test
+    fun testLargeFrames() = testClient {
+        config { install(WebSockets) }
+
+        test { client ->
+            // Larger than the socket buffers, so libcurl takes the frames partially
+            val payload = ByteArray(8 * 1024 * 1024) { (it % 251).toByte() }
+            // The test server doesn't accept frames of this size
+            withEchoWebSocketServer { url ->
+                client.webSocket(url) {
+                    launch {
+                        repeat(3) { outgoing.send(Frame.Binary(fin = true, payload)) }
+                    }
+                    repeat(3) {
+                        val frame = incoming.receive() as Frame.Binary
+                        assertContentEquals(payload, frame.data)
+                    }
+                }
+            }
+        }
+    }
+
+    @Test
+    fun testSlowConsumerWithSuspendingIncomingChannel() = testClient {
+        config {
+            install(WebSockets) {
+                channels {
+                    incoming = bounded(capacity = 1, onOverflow = ChannelOverflow.SUSPEND)
+                }
+            }
+        }
+
+        test { client ->
+            client.webSocket("$TEST_WEBSOCKET_SERVER/websockets/receive-backpressure") {
+                // The server sends the frames at once, none of them is dropped while the consumer lags behind
+                for (index in 0..1000) {
+                    val frame = incoming.receive() as Frame.Text
+                    assertEquals("Hello $index", frame.readText())
+                    if (index % 100 == 0) delay(50)
+                }
+            }
+        }
+    }
+
+    @Test
+    fun testDeflateExtension() = testClient {
+        config {
+            install(WebSockets) {
+                extensions {
+                    install(WebSocketDeflateExtension)
+                }
+            }
+        }
+
+        test { client ->
+            client.webSocket("$TEST_WEBSOCKET_SERVER/websockets/echo") {
+                assertTrue(extensions.any { it is WebSocketDeflateExtension })
+
+                // Compressed below the frame size limit of the test server, so only compressed frames pass
+                val text = """{"symbol":"KTOR","bid":1.5,"ask":1.6}""".repeat(2_000)
+                repeat(3) {
+                    outgoing.send(Frame.Text(text))
+                    assertEquals(text, (incoming.receive() as Frame.Text).readText())
+                }
+
+                val data = Random.nextBytes(1024)
+                outgoing.send(Frame.Binary(fin = true, data))
+                assertContentEquals(data, (incoming.receive() as Frame.Binary).data)
+            }
+        }
+    }
+
+    @Test
+    fun testDeflateExtensionNoContextTakeover() = testClient {
+        config {
+            install(WebSockets) {
+                extensions {
+                    install(WebSocketDeflateExtension) {
+                        clientNoContextTakeOver = true
+                        serverNoContextTakeOver = true
+                    }
+                }
+            }
+        }
+
+        test { client ->
+            client.webSocket("$TEST_WEBSOCKET_SERVER/websockets/echo") {
+                repeat(10) { index ->
+                    val text = "message $index ".repeat(1_000)
+                    outgoing.send(Frame.Text(text))
+                    assertEquals(text, (incoming.receive() as Frame.Text).readText())
+                }
+            }
+        }
+    }
+}
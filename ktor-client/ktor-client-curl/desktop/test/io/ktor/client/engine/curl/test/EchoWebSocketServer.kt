@@ -0,0 +1,81 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.test
+
+import io.ktor.http.websocket.*
+import io.ktor.utils.io.*
+import io.ktor.websocket.*
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.coroutineScope
+
+/**
+ * Runs a WebSocket server echoing the frames back as they are for the duration of the [block].
+ * Unlike the test server, it doesn't limit the frame size.
+ */
+internal suspend fun withEchoWebSocketServer(port: Int = 0, block: suspend (url: String) -> Unit) =
+    withWebSocketServer(::echoFrames, port, block)
+
+/**
+ * Runs a WebSocket server passing each accepted session to the [handler] for the duration of the [block].
+ * The session is closed once the [handler] returns. The server listens on a free port unless [port] is given.
+ */
+internal suspend fun withWebSocketServer(
+    handler: suspend (WebSocketSession) -> Unit,
+    port: Int = 0,
+    block: suspend (url: String) -> Unit,
+) = withRawWebSocketServer({ input, output -> serveWebSocket(input, output, handler) }, port, block)
+
+/**
+ * Runs a WebSocket server passing the channels of each connection to the [handler] once the handshake is accepted,
+ * for tests that read and write the frames byte by byte.
+ */
+internal suspend fun withRawWebSocketServer(
+    handler: suspend (input: ByteReadChannel, output: ByteWriteChannel) -> Unit,
+    port: Int = 0,
+    block: suspend (url: String) -> Unit,
+) = withTcpServer(
+    handler = { input, output ->
+        acceptWebSocketHandshake(input, output)
+        handler(input, output)
+    },
+    port = port,
+) { boundPort -> block("ws://127.0.0.1:$boundPort/") }
+
+private suspend fun serveWebSocket(
+    input: ByteReadChannel,
+    output: ByteWriteChannel,
+    handler: suspend (WebSocketSession) -> Unit,
+) = coroutineScope {
+    val session = RawWebSocket(input, output, coroutineContext = coroutineContext)
+    handler(session)
+    session.flush()
+    session.cancel()
+}
+
+private suspend fun echoFrames(session: WebSocketSession) {
+    for (frame in session.incoming) {
+        session.outgoing.send(frame)
+        if (frame is Frame.Close) break
+    }
+}
+
+/**
+ * Reads the upgrade request from the [input] and replies with `101 Switching Protocols` to the [output].
+ */
+private suspend fun acceptWebSocketHandshake(input: ByteReadChannel, output: ByteWriteChannel) {
+    var key = ""
+    while (true) {
+        val line = input.readUTF8Line() ?: break
+        if (line.isEmpty()) break
+        if (line.startsWith("Sec-WebSocket-Key:", ignoreCase = true)) key = line.substringAfter(':').trim()
+    }
+    output.writeStringUtf8(
+        "HTTP/1.1 101 Switching Protocols\r\n" +
+            "Upgrade: websocket\r\n" +
+            "Connection: Upgrade\r\n" +
+            "Sec-WebSocket-Accept: ${websocketServerAccept(key)}\r\n\r\n"
+    )
+    output.flush()
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.test
+
+import io.ktor.client.*
+import io.ktor.client.engine.curl.*
+import io.ktor.network.selector.*
+import io.ktor.network.sockets.*
+import io.ktor.server.application.*
+import io.ktor.server.cio.*
+import io.ktor.server.engine.*
+import io.ktor.server.routing.*
+import io.ktor.utils.io.*
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.coroutineScope
+import kotlinx.coroutines.launch
+
+/**
+ * Runs a CIO server serving the [routes] and a Curl client configured with [clientConfig]
+ * for the duration of the [block]. The server listens on a free loopback port unless other [connectors] are given.
+ * The [block] receives the client and the base URL of the first connector.
+ */
+internal suspend fun withEmbeddedServer(
+    routes: Routing.() -> Unit,
+    clientConfig: HttpClientConfig<CurlClientEngineConfig>.() -> Unit = {},
+    connectors: CIOApplicationEngine.Configuration.() -> Unit = {
+        connector {
+            host = "127.0.0.1"
+            port = 0
+        }
+    },
+    block: suspend (client: HttpClient, url: String) -> Unit,
+) {
+    val server = embeddedServer(
+        CIO,
+        serverConfig {
+            module { routing(routes) }
+        },
+        configure = connectors
+    )
+
+    try {
+        server.startSuspend(wait = false)
+        // Completes once the server is bound to its ports and socket files
+        val connector = server.engine.resolvedConnectors().first()
+        HttpClient(Curl, clientConfig).use { client ->
+            block(client, "http://${connector.host}:${connector.port}")
+        }
+    } finally {
+        server.stopSuspend(0, 0)
+    }
+}
+
+/**
+ * Runs a TCP server passing the channels of each accepted connection to the [handler] for the duration of the [block].
+ * The connection is closed once the [handler] returns.
+ * The server listens on a free loopback port unless [port] is given, and the [block] receives the bound port.
+ */
+internal suspend fun withTcpServer(
+    handler: suspend (input: ByteReadChannel, output: ByteWriteChannel) -> Unit,
+    port: Int = 0,
+    block: suspend (port: Int) -> Unit,
+) = coroutineScope {
+    SelectorManager().use { selector ->
+        aSocket(selector).tcp().bind("127.0.0.1", port).use { server ->
+            val serverJob = launch {
+                while (true) {
+                    val connection = server.accept()
+                    launch {
+                        connection.use { handler(it.openReadChannel(), it.openWriteChannel()) }
+                    }
+                }
+            }
+            try {
+                block((server.localAddress as InetSocketAddress).port)
+            } finally {
+                serverJob.cancel()
+            }
+        }
+    }
+}
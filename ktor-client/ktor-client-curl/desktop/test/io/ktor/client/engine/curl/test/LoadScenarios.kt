@@ -0,0 +1,253 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.test
+
+import io.ktor.client.engine.curl.*
+import io.ktor.client.request.*
+import io.ktor.client.test.base.*
+import io.ktor.http.*
+
+// The Jetty server of the test server, which negotiates HTTP/2 with ALPN
+private const val TLS_SERVER = "https://localhost:8089"
+
+// The Netty server of the test server, which accepts HTTP/2 without TLS
+private const val HTTP2_SERVER = "http://127.0.0.1:8084"
+
+// The servers run by CurlLoadTest itself, see withLocalLoadServers
+private const val LOCAL_HTTP_SERVER = "http://127.0.0.1:$LOCAL_HTTP_PORT"
+private const val LOCAL_WEBSOCKET_SERVER = "ws://127.0.0.1:$LOCAL_WEBSOCKET_PORT/"
+
+private const val LARGE_BODY_SIZE = 16 * 1024 * 1024
+
+internal enum class LoadEngine {
+    Curl,
+    CIO,
+}
+
+internal enum class LoadKind {
+    /** `GET` requests on the connections kept by the client. */
+    Get,
+
+    /** `POST` requests with an in-memory body of [LoadScenario.payloadSize] bytes. */
+    Upload,
+
+    /**
+     * `GET` requests each made by a new client, so each of them opens a new connection.
+     * The time includes starting and closing the client, which the plain HTTP scenario shows on its own.
+     */
+    NewConnection,
+
+    /** Binary messages of [LoadScenario.payloadSize] bytes echoed back by the server, one session per worker. */
+    WebSocketEcho,
+
+    /** `POST` requests with a `WriteChannelContent` body writing [LoadScenario.payloadSize] bytes. */
+    StreamedUpload,
+
+    /** `multipart/form-data` uploads of [LoadScenario.fileCount] files of [LoadScenario.payloadSize] bytes on disk. */
+    MultipartFiles,
+
+    /**
+     * Lines of [LoadScenario.payloadSize] bytes sent in the body of a duplex request and echoed back in its response,
+     * one request per worker.
+     */
+    DuplexEcho,
+}
+
+/**
+ * A scenario of [CurlLoadTest], which runs the same [operations] against each of the [engines].
+ * [concurrency] workers run the operations one after another, after a warm-up of a tenth of them.
+ * Each HTTP request is configured with [request], and the Curl engine with [curl].
+ *
+ * [backgroundConcurrency] workers download [backgroundUrl] over and over while the operations run.
+ * Their transfers are not counted in the results, except for the CPU time.
+ */
+internal class LoadScenario(
+    val name: String,
+    val kind: LoadKind,
+    val url: String,
+    val concurrency: Int,
+    val operations: Int,
+    val payloadSize: Int = 0,
+    val fileCount: Int = 0,
+    val engines: List<LoadEngine> = LoadEngine.entries,
+    val request: HttpRequestBuilder.() -> Unit = {},
+    val curl: CurlClientEngineConfig.() -> Unit = {},
+    val backgroundUrl: String? = null,
+    val backgroundConcurrency: Int = 0,
+)
+
+/**
+ * The scenarios compared by [CurlLoadTest]. They are run in this order against the local test server,
+ * so the results of two runs on the same machine can be compared.
+ * CIO doesn't support TLS on native targets and HTTP/2 at all, so these scenarios are run with Curl only.
+ */
+internal val LOAD_SCENARIOS: List<LoadScenario> = listOf(
+    LoadScenario("small GET x1", LoadKind.Get, "$TEST_SERVER/content/hello", concurrency = 1, operations = 2_000),
+    LoadScenario("small GET x16", LoadKind.Get, "$TEST_SERVER/content/hello", concurrency = 16, operations = 10_000),
+    LoadScenario("small GET x64", LoadKind.Get, "$TEST_SERVER/content/hello", concurrency = 64, operations = 20_000),
+    LoadScenario("loopback GET x1", LoadKind.Get, "$LOCAL_HTTP_SERVER/hello", concurrency = 1, operations = 10_000),
+    LoadScenario(
+        "Unix socket GET x1",
+        LoadKind.Get,
+        "http://localhost/hello",
+        concurrency = 1,
+        operations = 10_000,
+        request = { unixSocket(LOCAL_SOCKET_PATH) },
+    ),
+    LoadScenario(
+        "16 MiB download",
+        LoadKind.Get,
+        "$TEST_SERVER/download?size=$LARGE_BODY_SIZE",
+        concurrency = 1,
+        operations = 20,
+    ),
+    LoadScenario(
+        "small GET x16 next to gzip downloads",
+        LoadKind.Get,
+        "$TEST_SERVER/content/hello",
+        concurrency = 16,
+        operations = 10_000,
+        engines = listOf(LoadEngine.Curl),
+        backgroundUrl = "$TEST_SERVER/compression/large?encoding=gzip",
+        backgroundConcurrency = 4,
+    ),
+    LoadScenario(
+        "small GET x16 next to offloaded gzip downloads",
+        LoadKind.Get,
+        "$TEST_SERVER/content/hello",
+        concurrency = 16,
+        operations = 10_000,
+        engines = listOf(LoadEngine.Curl),
+        curl = { offloadContentDecoding = true },
+        backgroundUrl = "$TEST_SERVER/compression/large?encoding=gzip",
+        backgroundConcurrency = 4,
+    ),
+    LoadScenario(
+        "duplex echo x16",
+        LoadKind.DuplexEcho,
+        "$HTTP2_SERVER/echo/stream",
+        concurrency = 16,
+        operations = 50_000,
+        payloadSize = 64,
+        engines = listOf(LoadEngine.Curl),
+        request = { curl { duplexStreaming = true } },
+        curl = { duplexStreamingEnabled = true },
+    ),
+    decodingScenario("identity"),
+    decodingScenario("gzip"),
+    decodingScenario("deflate"),
+    LoadScenario(
+        "16 MiB upload",
+        LoadKind.Upload,
+        "$TEST_SERVER/upload/discard",
+        concurrency = 1,
+        operations = 20,
+        payloadSize = LARGE_BODY_SIZE,
+    ),
+    LoadScenario(
+        "small JSON POST x16",
+        LoadKind.Upload,
+        "$TEST_SERVER/upload/discard",
+        concurrency = 16,
+        operations = 10_000,
+        payloadSize = 256,
+        request = { contentType(ContentType.Application.Json) },
+    ),
+    LoadScenario(
+        "100 MiB upload",
+        LoadKind.Upload,
+        "$TEST_SERVER/upload/discard",
+        concurrency = 1,
+        operations = 5,
+        payloadSize = 100 * 1024 * 1024,
+    ),
+    LoadScenario(
+        "small streamed POST x16",
+        LoadKind.StreamedUpload,
+        "$TEST_SERVER/upload/discard",
+        concurrency = 16,
+        operations = 10_000,
+        payloadSize = 256,
+    ),
+    LoadScenario(
+        "16 MiB streamed upload",
+        LoadKind.StreamedUpload,
+        "$TEST_SERVER/upload/discard",
+        concurrency = 1,
+        operations = 20,
+        payloadSize = LARGE_BODY_SIZE,
+    ),
+    LoadScenario(
+        "multipart upload of 100 files",
+        LoadKind.MultipartFiles,
+        "$TEST_SERVER/upload/discard",
+        concurrency = 1,
+        operations = 100,
+        payloadSize = 64 * 1024,
+        fileCount = 100,
+    ),
+    LoadScenario(
+        "HTTP/2 multiplexed GET x64",
+        LoadKind.Get,
+        "$TLS_SERVER/",
+        concurrency = 64,
+        operations = 10_000,
+        engines = listOf(LoadEngine.Curl),
+    ),
+    LoadScenario("new HTTP connection", LoadKind.NewConnection, "$TEST_SERVER/content/hello", 1, operations = 200),
+    LoadScenario(
+        "new TLS connection",
+        LoadKind.NewConnection,
+        "$TLS_SERVER/",
+        concurrency = 1,
+        operations = 200,
+        engines = listOf(LoadEngine.Curl),
+    ),
+    LoadScenario(
+        "WebSocket echo x16",
+        LoadKind.WebSocketEcho,
+        "$TEST_WEBSOCKET_SERVER/websockets/echo",
+        concurrency = 16,
+        operations = 20_000,
+        payloadSize = 64,
+    ),
+    LoadScenario(
+        "WebSocket echo 4 KiB x16",
+        LoadKind.WebSocketEcho,
+        LOCAL_WEBSOCKET_SERVER,
+        concurrency = 16,
+        operations = 20_000,
+        payloadSize = 4 * 1024,
+    ),
+    LoadScenario(
+        "WebSocket echo 64 KiB x4",
+        LoadKind.WebSocketEcho,
+        LOCAL_WEBSOCKET_SERVER,
+        concurrency = 4,
+        operations = 5_000,
+        payloadSize = 64 * 1024,
+    ),
+    LoadScenario(
+        "WebSocket echo 1 MiB x1",
+        LoadKind.WebSocketEcho,
+        LOCAL_WEBSOCKET_SERVER,
+        concurrency = 1,
+        operations = 200,
+        payloadSize = 1024 * 1024,
+    ),
+)
+
+/**
+ * Downloads a body of about 8 MiB of JSON sent with the [encoding], so the CPU time shows the cost of decoding it.
+ * libcurl decodes the body, while CIO leaves it to the `ContentEncoding` plugin, so the scenario runs with Curl only.
+ */
+private fun decodingScenario(encoding: String): LoadScenario = LoadScenario(
+    "8 MiB $encoding download",
+    LoadKind.Get,
+    "$TEST_SERVER/compression/large?encoding=$encoding",
+    concurrency = 1,
+    operations = 50,
+    engines = listOf(LoadEngine.Curl),
+)
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.test
+
+import io.ktor.server.cio.*
+import io.ktor.server.engine.*
+import io.ktor.server.response.*
+import io.ktor.server.routing.*
+import kotlinx.io.files.Path
+import kotlinx.io.files.SystemFileSystem
+import kotlinx.io.files.SystemTemporaryDirectory
+
+internal const val LOCAL_HTTP_PORT = 8091
+internal const val LOCAL_WEBSOCKET_PORT = 8092
+internal val LOCAL_SOCKET_PATH: String = Path(SystemTemporaryDirectory, "ktor-curl-load-test.sock").toString()
+
+/**
+ * Runs the servers of the [LOAD_SCENARIOS] that the test server can't play for the duration of the [block]:
+ * an HTTP server listening on both [LOCAL_HTTP_PORT] and the [LOCAL_SOCKET_PATH] Unix socket,
+ * so both transports are compared against the same server, and a WebSocket echo server on [LOCAL_WEBSOCKET_PORT].
+ */
+internal suspend fun withLocalLoadServers(block: suspend () -> Unit) {
+    // A socket file left by an interrupted run would fail the bind
+    SystemFileSystem.delete(Path(LOCAL_SOCKET_PATH), mustExist = false)
+    try {
+        withEmbeddedServer(
+            routes = {
+                get("/hello") {
+                    call.respondText("Hello, world")
+                }
+            },
+            connectors = {
+                connector {
+                    host = "127.0.0.1"
+                    port = LOCAL_HTTP_PORT
+                }
+                unixConnector(LOCAL_SOCKET_PATH)
+            },
+        ) { _, _ ->
+            withEchoWebSocketServer(LOCAL_WEBSOCKET_PORT) { block() }
+        }
+    } finally {
+        SystemFileSystem.delete(Path(LOCAL_SOCKET_PATH), mustExist = false)
+    }
+}
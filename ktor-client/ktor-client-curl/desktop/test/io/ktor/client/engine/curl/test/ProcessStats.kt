@@ -0,0 +1,59 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.test
+
+import kotlinx.cinterop.ExperimentalForeignApi
+import kotlinx.io.buffered
+import kotlinx.io.files.Path
+import kotlinx.io.files.SystemFileSystem
+import kotlinx.io.readString
+import platform.posix.CLOCKS_PER_SEC
+import platform.posix.clock
+import kotlin.time.Duration
+import kotlin.time.Duration.Companion.microseconds
+
+private val PROC_STATUS = Path("/proc/self/status")
+
+/**
+ * Returns the resident set size of the process in bytes, or `null` where `/proc` is not available.
+ */
+internal fun residentSetSize(): Long? {
+    if (!SystemFileSystem.exists(PROC_STATUS)) return null
+    val status = SystemFileSystem.source(PROC_STATUS).buffered().use { it.readString() }
+    val line = status.lineSequence().firstOrNull { it.startsWith("VmRSS:") } ?: return null
+    // The value is in kB, as in "VmRSS:    12345 kB"
+    return line.substringAfter(':').trim().substringBefore(' ').toLong() * 1024
+}
+
+/**
+ * Returns the CPU time used by all the threads of the process so far.
+ */
+@OptIn(ExperimentalForeignApi::class)
+internal fun processCpuTime(): Duration = (clock().toLong() * 1_000_000 / CLOCKS_PER_SEC.toLong()).microseconds
+
+/**
+ * Returns the CPU time used by all the threads of the process while the [block] runs.
+ */
+internal suspend fun measureProcessCpuTime(block: suspend () -> Unit): Duration {
+    val start = processCpuTime()
+    block()
+    return processCpuTime() - start
+}
+
+/**
+ * Returns the value below which the [fraction] of the sorted [values] falls, such as `0.99` for p99.
+ */
+internal fun <T : Comparable<T>> List<T>.percentile(fraction: Double): T {
+    require(isNotEmpty()) { "No values to take a percentile of" }
+    val index = ((size - 1) * fraction).toInt()
+    return this[index]
+}
+
+internal fun formatBytes(bytes: Long?): String = when {
+    bytes == null -> "n/a"
+    bytes >= 1024 * 1024 -> "${bytes / (1024 * 1024)} MiB"
+    bytes >= 1024 -> "${bytes / 1024} KiB"
+    else -> "$bytes B"
+}
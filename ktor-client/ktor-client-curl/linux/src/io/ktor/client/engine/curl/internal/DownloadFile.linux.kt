@@ -0,0 +1,34 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.client.engine.curl.internal
+
+import kotlinx.cinterop.CPointer
+import kotlinx.cinterop.ExperimentalForeignApi
+import platform.posix.*
+
+@OptIn(ExperimentalForeignApi::class)
+internal actual fun openDownloadFile(path: String, offset: Long): CPointer<FILE>? {
+    if (offset == 0L) return fopen(path, "wb")
+
+    val file = fopen(path, "r+b") ?: return null
+    if (fseeko(file, offset, SEEK_SET) != 0) {
+        fclose(file)
+        return null
+    }
+    return file
+}
+
+@OptIn(ExperimentalForeignApi::class)
+internal actual fun prepareDownloadFile(file: CPointer<FILE>, offset: Long, expectedSize: Long) {
+    if (expectedSize <= 0) return
+    // Allocating the whole range upfront avoids fragmentation; the download still works if it fails
+    posix_fallocate(fileno(file), offset, expectedSize)
+}
+
+@OptIn(ExperimentalForeignApi::class)
+internal actual fun trimDownloadFile(file: CPointer<FILE>, size: Long) {
+    fflush(file)
+    ftruncate(fileno(file), size)
+}
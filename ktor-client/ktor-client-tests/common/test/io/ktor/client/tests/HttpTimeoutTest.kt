@@ -24,7 +24,7 @@ private const val TEST_URL = "$TEST_SERVER/timeout"
 
 // TODO: KTOR-8570 Investigate request timeout behavior in Android engine
 private val ENGINES_WITHOUT_REQUEST_TIMEOUT = listOf("Android")
-private val ENGINES_WITHOUT_SOCKET_TIMEOUT = listOf("Java", "Curl", "Js")
+private val ENGINES_WITHOUT_SOCKET_TIMEOUT = listOf("Java", "Js")
 
 class HttpTimeoutTest : ClientLoader(timeout = 30.seconds) {
     @Test
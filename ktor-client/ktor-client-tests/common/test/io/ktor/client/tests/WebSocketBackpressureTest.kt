@@ -18,8 +18,9 @@ import kotlin.time.Duration.Companion.seconds
 
 private const val FRAMES_COUNT = 100
 
-private val NON_CALLBACK_BASED_WS_CLIENTS = listOf("CIO", "Darwin", "Java", "WinHttp")
-private val CALLBACK_BASED_WS_CLIENTS = listOf("OkHttp", "JS", "Curl")
+// Curl is callback-based too, but it pauses the transfer while the incoming channel is full
+private val NON_CALLBACK_BASED_WS_CLIENTS = listOf("CIO", "Darwin", "Java", "WinHttp", "Curl")
+private val CALLBACK_BASED_WS_CLIENTS = listOf("OkHttp", "JS")
 
 class WebSocketBackpressureTest : ClientLoader(except(ENGINES_WITHOUT_WS)) {
 
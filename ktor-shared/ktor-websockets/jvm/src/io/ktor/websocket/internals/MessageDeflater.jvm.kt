@@ -0,0 +1,29 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.websocket.internals
+
+import java.util.zip.Deflater
+import java.util.zip.Inflater
+
+internal actual class MessageDeflater actual constructor(level: Int) {
+    private val deflater = Deflater(level, true)
+
+    actual fun deflateFully(data: ByteArray): ByteArray = deflater.deflateFully(data)
+
+    actual fun reset() {
+        deflater.reset()
+    }
+}
+
+internal actual class MessageInflater actual constructor() {
+    private val inflater = Inflater(true)
+
+    actual fun inflateFully(data: ByteArray, maxOutputSize: Int): ByteArray =
+        inflater.inflateFully(data, maxOutputSize)
+
+    actual fun reset() {
+        inflater.reset()
+    }
+}
@@ -6,8 +6,6 @@ package io.ktor.websocket
 
 import io.ktor.util.*
 import io.ktor.websocket.internals.*
-import java.util.*
-import java.util.zip.*
 
 private const val SERVER_MAX_WINDOW_BITS: String = "server_max_window_bits"
 private const val CLIENT_NO_CONTEXT_TAKEOVER = "client_no_context_takeover"
@@ -19,6 +17,9 @@ private const val MAX_WINDOW_BITS: Int = 15
 private const val MIN_WINDOW_BITS: Int = 8
 internal const val MAX_INFLATED_FRAME_SIZE: Int = 256 * 1024 * 1024 // 256 MiB
 
+// The default level of zlib, which is 6
+private const val DEFAULT_COMPRESSION_LEVEL: Int = -1
+
 /**
  * Compress and decompress WebSocket frames to reduce amount of transferred bytes.
  *
@@ -32,7 +33,8 @@ internal const val MAX_INFLATED_FRAME_SIZE: Int = 256 * 1024 * 1024 // 256 MiB
  * ```
  *
  * Implements WebSocket deflate extension from [RFC-7692](https://tools.ietf.org/html/rfc7692).
- * This implementation is using window size = 15 due to limitations of [Deflater] implementation.
+ * Frames are compressed with `java.util.zip` on JVM and with zlib on native targets.
+ * This implementation is using window size = 15 due to limitations of the `Deflater` implementation.
  *
  * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.websocket.WebSocketDeflateExtension)
  */
@@ -43,8 +45,8 @@ public class WebSocketDeflateExtension internal constructor(
 
     override val protocols: List<WebSocketExtensionHeader> = config.build()
 
-    private val inflater = Inflater(true)
-    private val deflater = Deflater(config.compressionLevel, true)
+    private val inflater = MessageInflater()
+    private val deflater = MessageDeflater(config.compressionLevel)
 
     internal var outgoingNoContextTakeover: Boolean = false
     internal var incomingNoContextTakeover: Boolean = false
@@ -99,7 +101,7 @@ public class WebSocketDeflateExtension internal constructor(
         val parameters = mutableListOf<String>()
 
         for ((key, value) in protocol.parseParameters()) {
-            when (key.lowercase(Locale.getDefault())) {
+            when (key.lowercase()) {
                 SERVER_MAX_WINDOW_BITS -> {
                     check(value.toInt() == MAX_WINDOW_BITS) { "Only $MAX_WINDOW_BITS window size is supported" }
                 }
@@ -179,11 +181,11 @@ public class WebSocketDeflateExtension internal constructor(
         public var serverNoContextTakeOver: Boolean = false
 
         /**
-         * Compression level that is used for outgoing frames in the [Deflate] instance.
+         * Compression level from 0 to 9 that is used for outgoing frames, or -1 for the default level.
          *
          * [Report a problem](https://ktor.io/feedback/?fqname=io.ktor.websocket.WebSocketDeflateExtension.Config.compressionLevel)
          */
-        public var compressionLevel: Int = Deflater.DEFAULT_COMPRESSION
+        public var compressionLevel: Int = DEFAULT_COMPRESSION_LEVEL
 
         /**
          * Maximum inflated size of an inbound frame.
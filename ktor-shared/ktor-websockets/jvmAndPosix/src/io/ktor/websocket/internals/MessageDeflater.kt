@@ -0,0 +1,31 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.websocket.internals
+
+/**
+ * Compresses messages with raw deflate, keeping its window between messages until [reset].
+ */
+internal expect class MessageDeflater(level: Int) {
+    /**
+     * Compresses a whole message and returns it without the trailing empty block, see RFC 7692.
+     */
+    fun deflateFully(data: ByteArray): ByteArray
+
+    fun reset()
+}
+
+/**
+ * Decompresses raw deflate messages, keeping its window between messages until [reset].
+ */
+internal expect class MessageInflater() {
+    /**
+     * Decompresses a whole message sent without the trailing empty block.
+     *
+     * @throws kotlinx.io.IOException if the message is malformed or inflates to more than [maxOutputSize] bytes.
+     */
+    fun inflateFully(data: ByteArray, maxOutputSize: Int): ByteArray
+
+    fun reset()
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.websockets
+
+import io.ktor.websocket.*
+import kotlinx.io.IOException
+import kotlin.test.*
+
+class WebSocketDeflateExtensionTest {
+
+    @Test
+    fun testFramesAreCompressedAndRestored() {
+        val sender = WebSocketDeflateExtension.install {}
+        val receiver = WebSocketDeflateExtension.install {}
+
+        // The second message refers to the first one through the shared window
+        repeat(2) {
+            val text = "Hello, World! ".repeat(100)
+            val compressed = sender.processOutgoingFrame(Frame.Text(text))
+
+            assertTrue(compressed.rsv1)
+            assertTrue(compressed.data.size < text.length)
+
+            val restored = receiver.processIncomingFrame(compressed)
+            assertFalse(restored.rsv1)
+            assertEquals(text, (restored as Frame.Text).readText())
+        }
+    }
+
+    @Test
+    fun testControlFramesAreNotCompressed() {
+        val extension = WebSocketDeflateExtension.install {}
+        val ping = Frame.Ping(byteArrayOf(1, 2, 3))
+
+        assertSame(ping, extension.processOutgoingFrame(ping))
+    }
+
+    @Test
+    fun testInflatedFrameLimit() {
+        val sender = WebSocketDeflateExtension.install {}
+        val receiver = WebSocketDeflateExtension.install { maxInflatedFrameSize = 1024 }
+        val compressed = sender.processOutgoingFrame(Frame.Binary(true, ByteArray(2048)))
+
+        assertFailsWith<IOException> { receiver.processIncomingFrame(compressed) }
+    }
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2014-2026 JetBrains s.r.o and contributors. Use of this source code is governed by the Apache 2.0 license.
+ */
+
+package io.ktor.websocket.internals
+
+import kotlinx.cinterop.*
+import kotlinx.io.Buffer
+import kotlinx.io.IOException
+import kotlinx.io.readByteArray
+import platform.zlib.*
+import kotlin.experimental.ExperimentalNativeApi
+import kotlin.native.ref.Cleaner
+import kotlin.native.ref.createCleaner
+
+private const val ZLIB_BUFFER_SIZE = 8192
+
+// Negative window bits make zlib read and write raw deflate data without a header, as in RFC 7692
+private const val RAW_DEFLATE_WINDOW_BITS = -MAX_WBITS
+
+// The memory level deflateInit uses
+private const val DEFAULT_MEM_LEVEL = 8
+
+// A compressed message ends with an empty block flushed by Z_SYNC_FLUSH, which is not sent, see RFC 7692
+private val EMPTY_BLOCK_TAIL = byteArrayOf(0, 0, 0xff.toByte(), 0xff.toByte())
+
+/**
+ * A zlib stream compressing messages with raw deflate, keeping its window between messages until [reset].
+ * The native stream is released once the deflater is garbage collected.
+ */
+@OptIn(ExperimentalForeignApi::class, ExperimentalNativeApi::class)
+internal actual class MessageDeflater actual constructor(level: Int) {
+    private val stream = allocStream()
+
+    init {
+        val result = deflateInit2_(
+            stream.ptr,
+            level,
+            Z_DEFLATED,
+            RAW_DEFLATE_WINDOW_BITS,
+            DEFAULT_MEM_LEVEL,
+            Z_DEFAULT_STRATEGY,
+            zlibVersion()?.toKString(),
+            sizeOf<z_stream>().toInt()
+        )
+        if (result != Z_OK) {
+            nativeHeap.free(stream)
+            error("Failed to initialize deflater: $result")
+        }
+    }
+
+    @Suppress("unused")
+    private val cleaner: Cleaner = createCleaner(stream) { stream ->
+        deflateEnd(stream.ptr)
+        nativeHeap.free(stream)
+    }
+
+    /**
+     * Compresses a whole message and returns it without the trailing empty block.
+     */
+    actual fun deflateFully(data: ByteArray): ByteArray {
+        val output = Buffer()
+        stream.process(data, output) { deflate(it, Z_SYNC_FLUSH) }
+
+        val deflated = output.readByteArray()
+        return deflated.copyOf(maxOf(deflated.size - EMPTY_BLOCK_TAIL.size, 0))
+    }
+
+    actual fun reset() {
+        deflateReset(stream.ptr)
+    }
+}
+
+/**
+ * A zlib stream decompressing messages compressed by [MessageDeflater] or a peer,
+ * keeping its window between messages until [reset].
+ * The native stream is released once the inflater is garbage collected.
+ */
+@OptIn(ExperimentalForeignApi::class, ExperimentalNativeApi::class)
+internal actual class MessageInflater actual constructor() {
+    private val stream = allocStream()
+
+    init {
+        val result = inflateInit2_(
+            stream.ptr,
+            RAW_DEFLATE_WINDOW_BITS,
+            zlibVersion()?.toKString(),
+            sizeOf<z_stream>().toInt()
+        )
+        if (result != Z_OK) {
+            nativeHeap.free(stream)
+            error("Failed to initialize inflater: $result")
+        }
+    }
+
+    @Suppress("unused")
+    private val cleaner: Cleaner = createCleaner(stream) { stream ->
+        inflateEnd(stream.ptr)
+        nativeHeap.free(stream)
+    }
+
+    /**
+     * Decompresses a whole message sent without the trailing empty block.
+     *
+     * @throws IOException if the message is malformed or inflates to more than [maxOutputSize] bytes.
+     */
+    actual fun inflateFully(data: ByteArray, maxOutputSize: Int): ByteArray {
+        val output = Buffer()
+        stream.process(data + EMPTY_BLOCK_TAIL, output, maxOutputSize.toLong()) { inflate(it, Z_SYNC_FLUSH) }
+        return output.readByteArray()
+    }
+
+    actual fun reset() {
+        inflateReset(stream.ptr)
+    }
+}
+
+@OptIn(ExperimentalForeignApi::class)
+private fun allocStream(): z_stream = nativeHeap.alloc<z_stream>().apply {
+    zalloc = null
+    zfree = null
+    opaque = null
+    next_in = null
+    avail_in = 0u
+}
+
+/**
+ * Passes the whole [input] through the stream with [step], writing the produced bytes to the [output].
+ * Fails once the [output] grows over [maxOutputSize] bytes.
+ * A step that doesn't fill the output buffer has consumed all the input it could.
+ */
+@OptIn(ExperimentalForeignApi::class)
+private inline fun z_stream.process(
+    input: ByteArray,
+    output: Buffer,
+    maxOutputSize: Long = Long.MAX_VALUE,
+    step: (z_streamp) -> Int,
+) {
+    val buffer = ByteArray(ZLIB_BUFFER_SIZE)
+    input.usePinned { inputPinned ->
+        buffer.usePinned { bufferPinned ->
+            next_in = if (input.isEmpty()) null else inputPinned.addressOf(0).reinterpret()
+            avail_in = input.size.convert()
+            try {
+                do {
+                    next_out = bufferPinned.addressOf(0).reinterpret()
+                    avail_out = buffer.size.convert()
+
+                    val result = step(ptr)
+                    if (result != Z_OK && result != Z_BUF_ERROR && result != Z_STREAM_END) {
+                        throw IOException("Malformed compressed data: ${msg?.toKString() ?: result}")
+                    }
+                    output.write(buffer, 0, buffer.size - avail_out.toInt())
+                    if (output.size > maxOutputSize) {
+                        throw IOException("Inflated data exceeds limit: ${output.size} > $maxOutputSize")
+                    }
+                } while (avail_out.toInt() == 0)
+            } finally {
+                // The pinned arrays must not be referenced once they are unpinned
+                next_in = null
+                avail_in = 0u
+                next_out = null
+                avail_out = 0u
+            }
+        }
+    }
+}
@@ -13,6 +13,10 @@ import io.ktor.server.routing.*
 import io.ktor.util.*
 import io.ktor.utils.io.*
 import kotlinx.io.readByteArray
+import java.io.ByteArrayOutputStream
+import java.io.OutputStream
+import java.util.zip.DeflaterOutputStream
+import java.util.zip.GZIPOutputStream
 
 internal fun Application.encodingTestServer() {
     routing {
@@ -95,6 +99,15 @@ internal fun Application.encodingTestServer() {
                     })
                 }
             }
+            route("/large") {
+                get {
+                    val encoding = call.request.queryParameters["encoding"] ?: "identity"
+                    val body = LARGE_ENCODED_BODIES[encoding]
+                        ?: return@get call.respond(HttpStatusCode.BadRequest, "Unsupported encoding: $encoding")
+                    if (encoding != "identity") call.response.headers.append(HttpHeaders.ContentEncoding, encoding)
+                    call.respondBytes(body, ContentType.Application.Json)
+                }
+            }
             route("/head-gzip-with-content-length") {
                 head {
                     val content = "Hello, world"
@@ -115,6 +128,33 @@ internal fun Application.encodingTestServer() {
     }
 }
 
+// About 8 MiB of JSON lines, compressible like a typical API response
+private val LARGE_BODY: ByteArray by lazy {
+    buildString {
+        var id = 0
+        while (length < 8 * 1024 * 1024) {
+            val price = "${id % 1000}.${id % 100}"
+            appendLine("{\"id\":$id,\"name\":\"item $id\",\"price\":$price,\"stock\":${id * 7 % 501}}")
+            id++
+        }
+    }.toByteArray()
+}
+
+// The large body encoded once with each encoding, so the server doesn't spend time compressing it for each request
+private val LARGE_ENCODED_BODIES: Map<String, ByteArray> by lazy {
+    mapOf(
+        "identity" to LARGE_BODY,
+        "gzip" to encode(LARGE_BODY) { GZIPOutputStream(it) },
+        "deflate" to encode(LARGE_BODY) { DeflaterOutputStream(it) },
+    )
+}
+
+private fun encode(data: ByteArray, encoder: (OutputStream) -> OutputStream): ByteArray {
+    val output = ByteArrayOutputStream()
+    encoder(output).use { it.write(data) }
+    return output.toByteArray()
+}
+
 private fun Route.setCompressionEndpoints() {
     get {
         call.respondText("Compressed response!")
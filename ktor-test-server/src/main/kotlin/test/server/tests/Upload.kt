@@ -6,8 +6,10 @@ package test.server.tests
 
 import io.ktor.http.*
 import io.ktor.server.application.*
+import io.ktor.server.request.*
 import io.ktor.server.response.*
 import io.ktor.server.routing.*
+import io.ktor.utils.io.*
 
 internal fun Application.uploadTest() {
     routing {
@@ -16,6 +18,10 @@ internal fun Application.uploadTest() {
                 val message = call.request.headers[HttpHeaders.ContentType] ?: "EMPTY"
                 call.respond(HttpStatusCode.OK, message)
             }
+            post("discard") {
+                val size = call.receiveChannel().discard()
+                call.respondText(size.toString())
+            }
         }
     }
 }